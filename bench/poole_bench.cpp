@@ -0,0 +1,527 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains the micro-benchmarks for the hot paths of the Poole
+ *          scheduler. Every benchmark is run for 1..N threads and the results
+ *          are written as CSV or JSON so that releases and scheduler options
+ *          can be compared with one another.
+ *
+ *          Usage: Poole_bench [--threads N] [--tasks N] [--reps N]
+ *                             [--producers N] [--format csv|json] [--output FILE]
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Poole.h"
+
+#ifndef POOLE_VERSION
+#define POOLE_VERSION "unknown"
+#endif
+
+//------------------------------------------------------------------------------
+// Allocation counting
+//------------------------------------------------------------------------------
+// Every allocation made by the process goes through these counters, which lets
+// the benchmarks report how many allocations the pool performs per task.
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_allocated_bytes{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC inlines these into callers that got the memory from operator new and
+// takes the free() for a mismatch, although this operator new uses malloc()
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Scheduler options compared against the default Poole
+using PooleNoStats = BasicPoole<QueuePolicy::Fifo, IdlePolicy::Futex, StatsPolicy::None,
+    std::function<void()>>;
+using PooleSpin = BasicPoole<QueuePolicy::Fifo, IdlePolicy::Spin<>, StatsPolicy::Full,
+    std::function<void()>>;
+using PooleRealtime = RealtimePoole<1024, 64>;
+using PooleCondVar = BasicPoole<QueuePolicy::Fifo, IdlePolicy::CondVar, StatsPolicy::Full,
+    std::function<void()>>;
+using PooleSharded = BasicPoole<QueuePolicy::Sharded<>, IdlePolicy::Futex, StatsPolicy::Full,
+    std::function<void()>>;
+using PooleStdFunction = BasicPoole<QueuePolicy::Fifo, IdlePolicy::Futex, StatsPolicy::Full,
+    std::function<void()>>;
+
+struct BenchOptions {
+    uint32_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t tasks = 100000;
+    uint32_t repetitions = 1000;
+    uint32_t producers = 4;
+    std::string format = "csv";
+    std::string output = "";
+};
+
+struct BenchResult {
+    std::string benchmark;
+    std::string pool;
+    uint32_t threads;
+    std::string metric;
+    double value;
+    std::string unit;
+};
+
+double elapsed_ns(Clock::time_point start, Clock::time_point end) {
+    return static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+double percentile(std::vector<double> values, double fraction) {
+    // Nearest-rank percentile, the input is copied so it can be sorted
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    auto index = static_cast<size_t>(fraction * static_cast<double>(values.size() - 1));
+    return values[index];
+}
+
+double mean(const std::vector<double>& values) {
+    double total = 0.0;
+    for (auto value : values) {
+        total += value;
+    }
+    return values.empty() ? 0.0 : total / static_cast<double>(values.size());
+}
+
+//------------------------------------------------------------------------------
+// Benchmarks
+//------------------------------------------------------------------------------
+// Submits empty tasks as fast as possible and waits for all of them
+template <typename Pool>
+void bench_empty_task_throughput(const char* pool_name, uint32_t threads,
+        const BenchOptions& options, std::vector<BenchResult>& results) {
+    Pool pool{static_cast<int32_t>(threads)};
+
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < options.tasks; ++i) {
+        pool.add_function([]() {});
+    }
+    pool.wait();
+    auto total_ns = elapsed_ns(start, Clock::now());
+
+    auto actual = pool.get_possible_threads();
+    results.push_back({"empty_task_throughput", pool_name, actual, "tasks_per_second",
+            static_cast<double>(options.tasks) * 1e9 / total_ns, "tasks/s"});
+    results.push_back({"empty_task_throughput", pool_name, actual, "time_per_task",
+            total_ns / static_cast<double>(options.tasks), "ns"});
+}
+
+// Measures the time from add_function() to the task starting on an idle pool
+template <typename Pool>
+void bench_submit_to_start_latency(const char* pool_name, uint32_t threads,
+        const BenchOptions& options, std::vector<BenchResult>& results) {
+    Pool pool{static_cast<int32_t>(threads)};
+    std::vector<double> latencies(options.repetitions, 0.0);
+
+    for (uint32_t i = 0; i < options.repetitions; ++i) {
+        double* slot = &latencies[i];
+        auto submitted = Clock::now();
+        pool.add_function([slot, submitted]() {
+            *slot = elapsed_ns(submitted, Clock::now());
+        });
+        pool.wait();
+    }
+
+    auto actual = pool.get_possible_threads();
+    results.push_back({"submit_to_start_latency", pool_name, actual, "mean", mean(latencies), "ns"});
+    results.push_back({"submit_to_start_latency", pool_name, actual, "p50",
+            percentile(latencies, 0.50), "ns"});
+    results.push_back({"submit_to_start_latency", pool_name, actual, "p99",
+            percentile(latencies, 0.99), "ns"});
+}
+
+// Fans a round of small tasks out across the pool and joins them with wait()
+template <typename Pool>
+void bench_fan_out_fan_in(const char* pool_name, uint32_t threads, const BenchOptions& options,
+        std::vector<BenchResult>& results) {
+    Pool pool{static_cast<int32_t>(threads)};
+    const uint32_t fan_width = 8 * pool.get_possible_threads();
+    const uint32_t rounds = std::max(1u, options.repetitions / 10);
+    std::atomic<uint64_t> counter{0};
+
+    auto start = Clock::now();
+    for (uint32_t round = 0; round < rounds; ++round) {
+        for (uint32_t i = 0; i < fan_width; ++i) {
+            pool.add_function([&counter]() {
+                counter.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        pool.wait();
+    }
+    auto total_ns = elapsed_ns(start, Clock::now());
+
+    auto actual = pool.get_possible_threads();
+    results.push_back({"fan_out_fan_in", pool_name, actual, "time_per_round",
+            total_ns / static_cast<double>(rounds), "ns"});
+    results.push_back({"fan_out_fan_in", pool_name, actual, "time_per_task",
+            total_ns / static_cast<double>(rounds * fan_width), "ns"});
+}
+
+// Measures the cost of calling wait() on a pool with nothing left to do
+template <typename Pool>
+void bench_wait_cost(const char* pool_name, uint32_t threads, const BenchOptions& options,
+        std::vector<BenchResult>& results) {
+    Pool pool{static_cast<int32_t>(threads)};
+    const uint32_t calls = options.repetitions * 10;
+
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < calls; ++i) {
+        pool.wait();
+    }
+    auto total_ns = elapsed_ns(start, Clock::now());
+
+    results.push_back({"wait_cost", pool_name, pool.get_possible_threads(), "time_per_call",
+            total_ns / static_cast<double>(calls), "ns"});
+}
+
+// Several producer threads submit into the same pool at the same time
+template <typename Pool>
+void bench_multi_producer(const char* pool_name, uint32_t threads, const BenchOptions& options,
+        std::vector<BenchResult>& results) {
+    Pool pool{static_cast<int32_t>(threads)};
+    const uint32_t producers = std::max(1u, options.producers);
+    const uint64_t tasks_per_producer = options.tasks / producers;
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> producer_threads;
+    producer_threads.reserve(producers);
+    for (uint32_t p = 0; p < producers; ++p) {
+        producer_threads.emplace_back([&pool, &go, tasks_per_producer]() {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (uint64_t i = 0; i < tasks_per_producer; ++i) {
+                pool.add_function([]() {});
+            }
+        });
+    }
+
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& producer : producer_threads) {
+        producer.join();
+    }
+    pool.wait();
+    auto total_ns = elapsed_ns(start, Clock::now());
+
+    auto total_tasks = static_cast<double>(tasks_per_producer * producers);
+    auto actual = pool.get_possible_threads();
+    results.push_back({"multi_producer", pool_name, actual, "tasks_per_second",
+            total_tasks * 1e9 / total_ns, "tasks/s"});
+    results.push_back({"multi_producer", pool_name, actual, "producers",
+            static_cast<double>(producers), "threads"});
+}
+
+// Counts the heap allocations made while submitting and running empty tasks
+template <typename Pool>
+void bench_allocations_per_task(const char* pool_name, uint32_t threads,
+        const BenchOptions& options, std::vector<BenchResult>& results) {
+    Pool pool{static_cast<int32_t>(threads)};
+
+    // Warm the pool up so one-off growth of internal buffers is not counted
+    for (uint64_t i = 0; i < options.tasks / 10; ++i) {
+        pool.add_function([]() {});
+    }
+    pool.wait();
+
+    auto allocations_before = g_allocations.load();
+    auto bytes_before = g_allocated_bytes.load();
+    for (uint64_t i = 0; i < options.tasks; ++i) {
+        pool.add_function([]() {});
+    }
+    pool.wait();
+    auto allocations = static_cast<double>(g_allocations.load() - allocations_before);
+    auto bytes = static_cast<double>(g_allocated_bytes.load() - bytes_before);
+
+    auto actual = pool.get_possible_threads();
+    results.push_back({"allocations_per_task", pool_name, actual, "allocations",
+            allocations / static_cast<double>(options.tasks), "allocs/task"});
+    results.push_back({"allocations_per_task", pool_name, actual, "bytes",
+            bytes / static_cast<double>(options.tasks), "bytes/task"});
+}
+
+// Counts the heap allocations made for tasks whose closure is too big to be
+// stored inline, which is where PooledFunction and std::function differ
+template <typename Pool>
+void bench_large_closure_allocations(const char* pool_name, uint32_t threads,
+        const BenchOptions& options, std::vector<BenchResult>& results) {
+    Pool pool{static_cast<int32_t>(threads)};
+    std::array<uint64_t, 24> payload{};
+    std::atomic<uint64_t> sum{0};
+    auto large_task = [payload, &sum]() {
+        sum.fetch_add(payload[0], std::memory_order_relaxed);
+    };
+
+    // A full warm-up round, so there are enough nodes in circulation to
+    // queue every task of the measured round at once
+    for (uint64_t i = 0; i < options.tasks; ++i) {
+        pool.add_function(large_task);
+    }
+    pool.wait();
+
+    auto allocations_before = g_allocations.load();
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < options.tasks; ++i) {
+        pool.add_function(large_task);
+    }
+    pool.wait();
+    auto total_ns = elapsed_ns(start, Clock::now());
+    auto allocations = static_cast<double>(g_allocations.load() - allocations_before);
+
+    auto actual = pool.get_possible_threads();
+    results.push_back({"large_closure", pool_name, actual, "allocations",
+            allocations / static_cast<double>(options.tasks), "allocs/task"});
+    results.push_back({"large_closure", pool_name, actual, "time_per_task",
+            total_ns / static_cast<double>(options.tasks), "ns"});
+}
+
+// Constructs a pool, runs one task and destroys it, as a short-lived process
+// would, with every worker started up front and with lazily started ones
+void bench_startup(uint32_t threads, const BenchOptions& options,
+        std::vector<BenchResult>& results) {
+    const uint64_t rounds = std::max<uint64_t>(1, std::min<uint64_t>(options.tasks / 1000, 200));
+    for (bool lazy : {false, true}) {
+        WorkerConfig config;
+        config.lazy_spawn = lazy;
+        std::vector<double> construct_ns;
+        std::vector<double> lifetime_ns;
+        uint32_t actual = threads;
+        for (uint64_t round = 0; round < rounds; ++round) {
+            auto start = Clock::now();
+            {
+                Poole pool{static_cast<int32_t>(threads), config};
+                construct_ns.push_back(elapsed_ns(start, Clock::now()));
+                pool.add_function([]() {});
+                pool.wait();
+                actual = pool.get_possible_threads();
+            }
+            lifetime_ns.push_back(elapsed_ns(start, Clock::now()));
+        }
+        const char* pool_name = lazy ? "Poole_lazy" : "Poole";
+        results.push_back({"startup", pool_name, actual, "construct_p50", percentile(construct_ns, 0.5), "ns"});
+        results.push_back({"startup", pool_name, actual, "one_task_lifetime_p50", percentile(lifetime_ns, 0.5), "ns"});
+    }
+}
+
+// Tasks that update per-shard data, submitted through the shared queue and
+// keyed by shard so that a shard keeps being processed on the same worker
+template <typename Pool>
+void bench_keyed_locality(const char* pool_name, uint32_t threads, const BenchOptions& options,
+        std::vector<BenchResult>& results) {
+    Pool pool{static_cast<int32_t>(threads)};
+    const uint32_t shards = 4 * pool.get_possible_threads();
+    const size_t shard_values = 16 * 1024; // 128 KB per shard, roughly an L2 slice
+    const uint64_t tasks = std::max<uint64_t>(shards, options.tasks / 20);
+    std::vector<std::vector<uint64_t>> data(shards, std::vector<uint64_t>(shard_values, 1));
+
+    auto touch_shard = [&data](uint32_t shard) {
+        for (auto& value : data[shard]) {
+            value += 1;
+        }
+    };
+
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < tasks; ++i) {
+        uint32_t shard = static_cast<uint32_t>(i % shards);
+        pool.add_function([&touch_shard, shard]() { touch_shard(shard); });
+    }
+    pool.wait();
+    auto shared_ns = elapsed_ns(start, Clock::now());
+
+    start = Clock::now();
+    for (uint64_t i = 0; i < tasks; ++i) {
+        uint32_t shard = static_cast<uint32_t>(i % shards);
+        pool.add_function_keyed(shard, [&touch_shard, shard]() { touch_shard(shard); });
+    }
+    pool.wait();
+    auto keyed_ns = elapsed_ns(start, Clock::now());
+
+    auto actual = pool.get_possible_threads();
+    results.push_back({"keyed_locality", pool_name, actual, "shared_tasks_per_second",
+            static_cast<double>(tasks) * 1e9 / shared_ns, "tasks/s"});
+    results.push_back({"keyed_locality", pool_name, actual, "keyed_tasks_per_second",
+            static_cast<double>(tasks) * 1e9 / keyed_ns, "tasks/s"});
+}
+
+template <typename Pool>
+void run_suite(const char* pool_name, const std::vector<uint32_t>& thread_counts,
+        const BenchOptions& options, std::vector<BenchResult>& results) {
+    for (auto threads : thread_counts) {
+        bench_empty_task_throughput<Pool>(pool_name, threads, options, results);
+        bench_submit_to_start_latency<Pool>(pool_name, threads, options, results);
+        bench_fan_out_fan_in<Pool>(pool_name, threads, options, results);
+        bench_wait_cost<Pool>(pool_name, threads, options, results);
+        bench_multi_producer<Pool>(pool_name, threads, options, results);
+        bench_allocations_per_task<Pool>(pool_name, threads, options, results);
+        bench_keyed_locality<Pool>(pool_name, threads, options, results);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Output
+//------------------------------------------------------------------------------
+void write_csv(std::ostream& out, const std::vector<BenchResult>& results) {
+    out << "version,benchmark,pool,threads,metric,value,unit\n";
+    for (const auto& result : results) {
+        out << POOLE_VERSION << "," << result.benchmark << "," << result.pool << ","
+            << result.threads << "," << result.metric << "," << result.value << ","
+            << result.unit << "\n";
+    }
+}
+
+void write_json(std::ostream& out, const std::vector<BenchResult>& results) {
+    out << "{\n  \"version\": \"" << POOLE_VERSION << "\",\n";
+    out << "  \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        out << "    {\"benchmark\": \"" << result.benchmark << "\", \"pool\": \"" << result.pool
+            << "\", \"threads\": " << result.threads << ", \"metric\": \"" << result.metric
+            << "\", \"value\": " << result.value << ", \"unit\": \"" << result.unit << "\"}";
+        out << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+bool parse_options(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        bool has_value = (i + 1 < argc);
+
+        if (argument == "--threads" && has_value) {
+            options.max_threads = std::max(1, std::atoi(argv[++i]));
+        } else if (argument == "--tasks" && has_value) {
+            options.tasks = std::max(1LL, std::atoll(argv[++i]));
+        } else if (argument == "--reps" && has_value) {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (argument == "--producers" && has_value) {
+            options.producers = std::max(1, std::atoi(argv[++i]));
+        } else if (argument == "--format" && has_value) {
+            options.format = argv[++i];
+        } else if (argument == "--output" && has_value) {
+            options.output = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--threads N] [--tasks N] [--reps N] [--producers N]"
+                      << " [--format csv|json] [--output FILE]" << std::endl;
+            return false;
+        }
+    }
+    return options.format == "csv" || options.format == "json";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parse_options(argc, argv, options)) {
+        return 1;
+    }
+
+    // Run for 1, 2, 4, ... threads, always finishing on the requested maximum.
+    // A pool clamps its count to the hardware threads, so each count is
+    // resolved by a lazy pool, which starts no threads, and run only once.
+    std::vector<uint32_t> requested;
+    for (uint32_t threads = 1; threads < options.max_threads; threads *= 2) {
+        requested.push_back(threads);
+    }
+    requested.push_back(options.max_threads);
+
+    WorkerConfig probe_config;
+    probe_config.lazy_spawn = true;
+    std::vector<uint32_t> thread_counts;
+    for (auto threads : requested) {
+        uint32_t actual = Poole{static_cast<int32_t>(threads), probe_config}.get_possible_threads();
+        if (std::find(thread_counts.begin(), thread_counts.end(), actual) == thread_counts.end()) {
+            thread_counts.push_back(actual);
+        }
+    }
+
+    std::vector<BenchResult> results;
+    run_suite<Poole>("Poole", thread_counts, options, results);
+    run_suite<PooleNoStats>("Poole_no_stats", thread_counts, options, results);
+    run_suite<PooleSpin>("Poole_spin", thread_counts, options, results);
+    run_suite<PooleRealtime>("Poole_realtime", thread_counts, options, results);
+    run_suite<PooleSharded>("Poole_sharded", thread_counts, options, results);
+    run_suite<PooleCondVar>("Poole_condvar", thread_counts, options, results);
+    for (auto threads : thread_counts) {
+        bench_large_closure_allocations<Poole>("Poole", threads, options, results);
+        bench_large_closure_allocations<PooleStdFunction>("Poole_std_function", threads, options, results);
+        bench_startup(threads, options, results);
+    }
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            std::cerr << "ERROR: Poole_bench - unable to open " << options.output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+
+    if (options.format == "json") {
+        write_json(out, results);
+    } else {
+        write_csv(out, results);
+    }
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains BlockingRegion, a guard a task holds around a call
+ *          that blocks, e.g. a read from disk. While a worker is inside one,
+ *          its pool lets a spare worker take its place on the CPU. Nested
+ *          regions count once, and off a worker the guard does nothing.
+ */
+
+#pragma once
+
+class BlockingRegion {
+ public:
+  /**
+   * @brief What the pool of the current worker does when it enters and
+   *          leaves a blocking region
+   */
+  class Handler {
+   public:
+    virtual ~Handler() = default;
+    virtual void enter() = 0;
+    virtual void leave() = 0;
+  };
+
+  BlockingRegion();
+  ~BlockingRegion();
+  BlockingRegion(const BlockingRegion&) = delete;
+  BlockingRegion& operator=(const BlockingRegion&) = delete;
+
+  /**
+   * @brief Whether the calling thread is inside a blocking region
+   */
+  static bool active();
+
+  /**
+   * @brief Makes handler the one regions on this thread report to, set by
+   *          the pool on each of its workers
+   */
+  static void set_current(Handler* handler);
+
+ private:
+  // The handler told about this region, null for a nested one
+  Handler* m_handler;
+};
@@ -0,0 +1,160 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains CpuBudget, which works out how many CPUs the process
+ *          may really use: the hardware threads, narrowed by the affinity mask
+ *          and by the CPU quota of its cgroup (cpu.max in cgroup v2, or
+ *          cpu.cfs_quota_us in v1). All files are read below a root directory
+ *          so that the logic can be tested against a fake /proc and /sys.
+ *          ThrottleWatch polls the cgroup's cpu.stat and suggests fewer
+ *          workers while the quota keeps being exhausted.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+/**
+ * @brief The throttling counters of a cgroup, as cpu.stat reports them
+ */
+struct CpuThrottle {
+  // Enforcement periods that passed, and those in which the quota ran out
+  uint64_t periods = 0;
+  uint64_t throttled_periods = 0;
+  // The time the cgroup's threads were held back, in nanoseconds
+  uint64_t throttled_ns = 0;
+};
+
+class CpuBudget {
+ public:
+  /**
+   * @brief Reads the budget of the calling process
+   *
+   * @param root the directory holding proc/ and sys/, "/" outside of tests
+   */
+  explicit CpuBudget(std::string root = "/");
+
+  /**
+   * @brief Get the CPUs the cgroup quota allows, the tightest limit of the
+   *          cgroup and all of its parents
+   *
+   * @return std::optional<double> e.g. 2.5 for "250000 100000", unset when
+   * 			the quota is unlimited or there is no cgroup
+   */
+  std::optional<double> quota() const;
+
+  /**
+   * @brief Get the number of CPUs in the affinity mask of the process
+   *
+   * @return uint32_t the CPU count, 0 when it cannot be read
+   */
+  uint32_t affinity() const;
+
+  /**
+   * @brief Get the number of threads that can run at once without being
+   *          throttled or sharing a CPU: the hardware threads, narrowed by the
+   *          affinity mask and the quota rounded up, and at least 1
+   */
+  uint32_t threads() const;
+
+  /**
+   * @brief Get the throttling counters of the process's cgroup
+   *
+   * @return std::optional<CpuThrottle> unset when there is no cpu.stat
+   */
+  std::optional<CpuThrottle> throttle() const;
+
+  /**
+   * @brief Get threads() of the calling process, read once and kept, for the
+   * 			default size of a pool
+   */
+  static uint32_t default_threads();
+
+ private:
+  // The directory of the process's cgroup in the v2 hierarchy, or in that of
+  // the v1 cpu controller, and the root of that hierarchy. Empty when there
+  // is none.
+  std::string cgroup_directory(bool& unified, std::string& hierarchy) const;
+
+  std::string m_root;
+};
+
+class ThrottleWatch {
+ public:
+  // Receives the number of workers to keep active
+  using Apply = std::function<void(uint32_t threads)>;
+
+  /**
+   * @brief Starts polling the throttling counters of budget every interval.
+   *          A poll that finds more than kThrottledShare of the periods since
+   *          the last one throttled takes one worker away, kCalmPolls quiet
+   *          polls in a row give one back, up to max_threads.
+   *
+   * @param budget where the counters are read from
+   * @param max_threads the most workers apply is ever given
+   * @param interval the time between two polls
+   * @param apply called from the polling thread whenever the count changes
+   */
+  ThrottleWatch(CpuBudget budget, uint32_t max_threads, std::chrono::milliseconds interval, Apply apply);
+  ~ThrottleWatch();
+  ThrottleWatch(const ThrottleWatch&) = delete;
+  ThrottleWatch& operator=(const ThrottleWatch&) = delete;
+
+  /**
+   * @brief Reads the counters once and adjusts the worker count. The polling
+   *          thread calls it every interval.
+   *
+   * @return uint32_t the number of workers to keep active
+   */
+  uint32_t poll();
+
+  /**
+   * @brief Get the number of workers the watch currently suggests
+   */
+  uint32_t threads() const;
+
+  // The share of periods that must be throttled before a worker is taken away
+  static constexpr double kThrottledShare = 0.05;
+  // The quiet polls in a row after which a worker is given back
+  static constexpr uint32_t kCalmPolls = 5;
+
+ private:
+  void run();
+
+  CpuBudget m_budget;
+  const uint32_t m_max_threads;
+  const std::chrono::milliseconds m_interval;
+  Apply m_apply;
+
+  // Guarded by m_mutex, polls may come from the thread and from callers
+  mutable std::mutex m_mutex;
+  std::condition_variable m_notifier;
+  std::optional<CpuThrottle> m_last;
+  uint32_t m_threads;
+  uint32_t m_calm = 0;
+  bool m_stop = false;
+  std::thread m_thread;
+};
@@ -0,0 +1,234 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains BasicExecutor, a named handle that lets one component
+ *          of a program submit to a shared Poole, and BasicExecutorGroup, which
+ *          shares the workers between the executors of a pool by weight. An
+ *          executor with weight 2 gets twice the worker time of one with
+ *          weight 1 while both have work, and all of it while the other is
+ *          idle, so components share one thread budget without starving
+ *          each other.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Watchdog.h"
+
+/**
+ * @brief What an executor has done so far
+ */
+struct ExecutorStats {
+  std::string name;
+  uint32_t weight = 1;
+  uint64_t tasks_executed = 0;
+  uint64_t pending = 0;
+  // The time its tasks ran, in nanoseconds
+  uint64_t run_ns = 0;
+};
+
+template <typename Pool>
+class BasicExecutorGroup;
+
+template <typename Pool>
+class BasicExecutor {
+ public:
+  using task_type = typename Pool::task_type;
+
+  /**
+   * @brief Adds a function to the executor. It runs on a worker of the pool
+   *          once this executor's share of the workers allows it.
+   *
+   * @param function_to_add is a lambda or a void function to execute
+   * @param site where the task comes from, the caller unless labelled
+   */
+  void add_function(task_type function_to_add, TaskSite site = TaskSite::current()) {
+    m_group->submit(*m_lane, std::move(function_to_add), site);
+  }
+
+  /**
+   * @brief Changes the share of the workers this executor gets
+   *
+   * @param weight relative to the other executors, at least 1
+   */
+  void set_weight(uint32_t weight) { m_group->set_weight(*m_lane, weight); }
+
+  const std::string& name() const { return m_lane->name; }
+  uint32_t weight() const { return m_lane->weight.load(std::memory_order_relaxed); }
+
+ private:
+  friend class BasicExecutorGroup<Pool>;
+  using Lane = typename BasicExecutorGroup<Pool>::Lane;
+
+  BasicExecutor(BasicExecutorGroup<Pool>* group, Lane* lane) : m_group(group), m_lane(lane) {}
+
+  BasicExecutorGroup<Pool>* m_group;
+  Lane* m_lane;
+};
+
+template <typename Pool>
+class BasicExecutorGroup {
+ public:
+  using task_type = typename Pool::task_type;
+
+  explicit BasicExecutorGroup(Pool& pool) : m_pool(pool) {}
+
+  /**
+   * @brief Get the executor with the given name, creating it on first use.
+   *          Asking again for an existing name sets its weight.
+   *
+   * @param name identifies the executor, e.g. the component using it
+   * @param weight its share of the workers relative to the other executors
+   */
+  BasicExecutor<Pool> get(const std::string& name, uint32_t weight) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& lane = m_lanes[name];
+    if (!lane){
+      lane = std::make_unique<Lane>(name);
+    }
+    lane->weight.store(std::max(1u, weight), std::memory_order_relaxed);
+    return BasicExecutor<Pool>(this, lane.get());
+  }
+
+  /**
+   * @brief Get the statistics of every executor, ordered by name
+   */
+  std::vector<ExecutorStats> stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<ExecutorStats> to_return;
+    to_return.reserve(m_lanes.size());
+    for (auto const& entry : m_lanes){
+      const Lane& lane = *entry.second;
+      to_return.push_back({lane.name, lane.weight.load(std::memory_order_relaxed), lane.executed,
+          static_cast<uint64_t>(lane.queue.size()), lane.run_ns});
+    }
+    return to_return;
+  }
+
+ private:
+  friend class BasicExecutor<Pool>;
+
+  // Assumed run time of a task before an executor has run any
+  static constexpr double kInitialCostNs = 1000.0;
+  // The most a task is charged, in multiples of its executor's average
+  static constexpr double kMaxOutlier = 4.0;
+
+  // A queued task keeps its own site, the dispatch that runs it may have been
+  // queued by another executor's submitter
+  struct Entry {
+    task_type task;
+    TaskSite site;
+    uint64_t submit_ns = 0;
+  };
+
+  struct Lane {
+    explicit Lane(std::string lane_name) : name(std::move(lane_name)) {}
+
+    const std::string name;
+    std::atomic<uint32_t> weight{1};
+    // Everything below is guarded by the group's mutex
+    std::deque<Entry> queue;
+    // The weighted time this executor has received, the lowest goes next
+    double virtual_time = 0.0;
+    // The average run time of its tasks, charged up front when one starts
+    double average_ns = kInitialCostNs;
+    uint64_t executed = 0;
+    uint64_t run_ns = 0;
+  };
+
+  // Every task queued on an executor puts one dispatch task on the pool. The
+  // pool decides when a dispatch runs, the group decides which executor's
+  // task it runs, so no worker is ever held back while there is work. The
+  // dispatch is a relay, the task it picks is reported under its own site.
+  void submit(Lane& lane, task_type function_to_add, const TaskSite& site) {
+    uint64_t submit_ns = m_pool.submit_time_ns();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (lane.queue.empty()){
+        // An executor that was idle starts level with the busiest, it cannot
+        // claim the time it did not use
+        lane.virtual_time = std::max(lane.virtual_time, m_virtual_clock);
+      }
+      lane.queue.push_back(Entry{std::move(function_to_add), site, submit_ns});
+    }
+    m_pool.add_function([this]() { dispatch(); }, TaskSite::relayed(site));
+  }
+
+  void set_weight(Lane& lane, uint32_t weight) {
+    lane.weight.store(std::max(1u, weight), std::memory_order_relaxed);
+  }
+
+  void dispatch() {
+    Lane* lane = nullptr;
+    Entry entry;
+    double charged = 0.0;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (auto& entry : m_lanes){
+        Lane* candidate = entry.second.get();
+        if (!candidate->queue.empty() && (lane == nullptr || candidate->virtual_time < lane->virtual_time)){
+          lane = candidate;
+        }
+      }
+      if (lane == nullptr){
+        return;
+      }
+      entry = std::move(lane->queue.front());
+      lane->queue.pop_front();
+
+      // Charge the expected cost now so that concurrent dispatches spread
+      // over the executors, and settle the difference once the task ran
+      m_virtual_clock = std::max(m_virtual_clock, lane->virtual_time);
+      charged = lane->average_ns / lane->weight.load(std::memory_order_relaxed);
+      lane->virtual_time += charged;
+    }
+
+    uint64_t start_ns = Watchdog::now_ns();
+    m_pool.run_as(entry.site, entry.submit_ns, entry.task);
+    entry.task = task_type();
+    uint64_t run_ns = Watchdog::now_ns() - start_ns;
+
+    // A single outlier, e.g. a task whose worker was preempted, costs at most
+    // a few average tasks. Tasks that really got slower still show through
+    // as the average follows them.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    double cost = std::min(static_cast<double>(run_ns), kMaxOutlier * lane->average_ns);
+    lane->virtual_time += cost / lane->weight.load(std::memory_order_relaxed) - charged;
+    lane->average_ns += (cost - lane->average_ns) / 8.0;
+    lane->executed++;
+    lane->run_ns += run_ns;
+  }
+
+  Pool& m_pool;
+  mutable std::mutex m_mutex;
+  std::map<std::string, std::unique_ptr<Lane>> m_lanes;
+  // The furthest virtual time any dispatched executor had reached
+  double m_virtual_clock = 0.0;
+};
@@ -0,0 +1,135 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains InplaceFunction, a move-only replacement for
+ *          std::function<void()> that stores its callable inside the object.
+ *          It never touches the heap, a callable that does not fit is a
+ *          compile error rather than a hidden allocation.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <std::size_t Capacity, std::size_t Alignment = alignof(std::max_align_t)>
+class InplaceFunction {
+ public:
+  InplaceFunction() noexcept = default;
+
+  /**
+   * @brief Stores a copy of the callable inside the function object
+   *
+   * @param callable is a lambda or any other void() callable
+   */
+  template <typename Callable,
+      typename = std::enable_if_t<!std::is_same<std::decay_t<Callable>, InplaceFunction>::value>>
+  InplaceFunction(Callable&& callable) {
+    using Stored = std::decay_t<Callable>;
+    static_assert(sizeof(Stored) <= Capacity,
+        "The callable does not fit in this InplaceFunction, capture less or raise the capacity");
+    static_assert(alignof(Stored) <= Alignment, "The callable is over-aligned for this InplaceFunction");
+
+    ::new (static_cast<void*>(&m_storage)) Stored(std::forward<Callable>(callable));
+    m_operations = &kOperations<Stored>;
+  }
+
+  InplaceFunction(InplaceFunction&& other) noexcept {
+    take(other);
+  }
+
+  InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+    if (this != &other) {
+      reset();
+      take(other);
+    }
+    return *this;
+  }
+
+  InplaceFunction(const InplaceFunction&) = delete;
+  InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+  ~InplaceFunction() {
+    reset();
+  }
+
+  /**
+   * @brief Calls the stored callable
+   */
+  void operator()() {
+    m_operations->invoke(&m_storage);
+  }
+
+  /**
+   * @brief Whether a callable is stored
+   */
+  explicit operator bool() const noexcept {
+    return m_operations != nullptr;
+  }
+
+  /**
+   * @brief Destroys the stored callable, if any
+   */
+  void reset() noexcept {
+    if (m_operations != nullptr) {
+      m_operations->destroy(&m_storage);
+      m_operations = nullptr;
+    }
+  }
+
+ private:
+  struct Operations {
+    void (*invoke)(void* storage);
+    void (*move)(void* from, void* to);
+    void (*destroy)(void* storage);
+  };
+
+  template <typename Stored>
+  static void invoke_stored(void* storage) {
+    (*static_cast<Stored*>(storage))();
+  }
+
+  template <typename Stored>
+  static void move_stored(void* from, void* to) {
+    ::new (to) Stored(std::move(*static_cast<Stored*>(from)));
+    static_cast<Stored*>(from)->~Stored();
+  }
+
+  template <typename Stored>
+  static void destroy_stored(void* storage) {
+    static_cast<Stored*>(storage)->~Stored();
+  }
+
+  template <typename Stored>
+  static constexpr Operations kOperations = {
+      &invoke_stored<Stored>, &move_stored<Stored>, &destroy_stored<Stored>};
+
+  void take(InplaceFunction& other) noexcept {
+    if (other.m_operations != nullptr) {
+      other.m_operations->move(&other.m_storage, &m_storage);
+      m_operations = other.m_operations;
+      other.m_operations = nullptr;
+    }
+  }
+
+  alignas(Alignment) unsigned char m_storage[Capacity];
+  const Operations* m_operations = nullptr;
+};
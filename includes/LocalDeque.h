@@ -0,0 +1,88 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains LocalDeque, the queue a worker keeps for the tasks its
+ *          own tasks submit. The owner takes the newest task first, whose data
+ *          its parent most likely just loaded into the cache, while idle
+ *          workers steal the oldest, which tends to be the biggest piece of
+ *          work left. The slots are allocated once, a full deque rejects the
+ *          task so the pool can fall back to its shared queue.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+template <typename Task>
+class LocalDeque {
+ public:
+  explicit LocalDeque(std::size_t capacity) : m_slots(capacity) {}
+
+  /**
+   * @brief Adds a task at the newest end
+   *
+   * @return true if the task was stored, false if the deque is full, in which
+   *          case the task is left untouched
+   */
+  bool push(Task&& task) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_size == m_slots.size()) {
+      return false;
+    }
+    m_slots[(m_head + m_size) % m_slots.size()] = std::move(task);
+    ++m_size;
+    return true;
+  }
+
+  /**
+   * @brief Takes the newest task, for the owner
+   */
+  bool pop_newest(Task& task) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_size == 0) {
+      return false;
+    }
+    --m_size;
+    task = std::move(m_slots[(m_head + m_size) % m_slots.size()]);
+    return true;
+  }
+
+  /**
+   * @brief Takes the oldest task, for a thief
+   */
+  bool steal_oldest(Task& task) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_size == 0) {
+      return false;
+    }
+    task = std::move(m_slots[m_head]);
+    m_head = (m_head + 1) % m_slots.size();
+    --m_size;
+    return true;
+  }
+
+ private:
+  std::mutex m_mutex;
+  std::vector<Task> m_slots;
+  std::size_t m_head = 0;
+  std::size_t m_size = 0;
+};
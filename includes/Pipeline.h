@@ -0,0 +1,339 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains BasicPipeline, a chain of stages run on the workers of
+ *          a Poole, e.g. read -> parse -> transform -> write. A serial source
+ *          fills items, then every stage processes them in turn. A stage is
+ *          parallel, serial and in the order the source produced the items,
+ *          or serial in any order. At most max_tokens items are in flight: an
+ *          item only goes back to the source once it left the last stage, so
+ *          a slow stage holds the source back instead of letting items pile
+ *          up. The items are allocated once and reused, passing an item on
+ *          costs no allocation.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Watchdog.h"
+
+/**
+ * @brief How a stage of a pipeline processes its items
+ */
+enum class StageMode {
+  // One item at a time, in the order the source produced them
+  serial_in_order,
+  // One item at a time, in whatever order they arrive
+  serial_out_of_order,
+  // Any number of items at once
+  parallel
+};
+
+template <typename Pool, typename Item>
+class BasicPipeline {
+ public:
+  // Fills the item with the next input, false once there is none left
+  using Source = std::function<bool(Item& item)>;
+  using Body = std::function<void(Item& item)>;
+
+  /**
+   * @brief Construct a pipeline on the pool. The items are default
+   *          constructed here and reused for every input, so stages must
+   *          overwrite what they read.
+   *
+   * @param pool runs the stages, it must outlive the pipeline
+   * @param max_tokens the most items in flight at once, at least 1
+   */
+  BasicPipeline(Pool& pool, uint32_t max_tokens)
+      : m_pool(pool), m_tokens(std::max(1u, max_tokens)), m_items(m_tokens), m_sequence(m_tokens, 0),
+        m_idle(m_tokens, 0) {}
+
+  BasicPipeline(const BasicPipeline&) = delete;
+  BasicPipeline& operator=(const BasicPipeline&) = delete;
+
+  /**
+   * @brief Sets the first stage, which runs serially
+   */
+  BasicPipeline& source(Source source) {
+    m_source = std::move(source);
+    return *this;
+  }
+
+  /**
+   * @brief Appends a stage after the source and the stages added before it
+   *
+   * @param mode how the stage processes its items
+   * @param body called with every item once
+   */
+  BasicPipeline& stage(StageMode mode, Body body) {
+    m_stages.push_back(std::make_unique<Stage>(mode, std::move(body), m_tokens));
+    return *this;
+  }
+
+  /**
+   * @brief Runs the pipeline until the source has no input left and every
+   *          item left the last stage. Called from a worker of the pool, the
+   *          worker runs queued tasks while it waits, so the stages make
+   *          progress even when it is the only worker.
+   *
+   * @param site where the stage tasks come from, the caller unless labelled
+   * @return uint64_t the number of items the source produced
+   */
+  uint64_t run(TaskSite site = TaskSite::current()) {
+    if (!m_source) {
+      return 0;
+    }
+    m_site = site;
+    m_exhausted = false;
+    m_source_busy = false;
+    m_produced = 0;
+    m_idle_count = 0;
+    m_live = m_tokens;
+    for (auto& stage : m_stages) {
+      stage->reset();
+    }
+
+    // One token starts at the source, every item it produces lets the next
+    // idle one follow
+    for (uint32_t token = m_tokens; token-- > 1;) {
+      m_idle[m_idle_count++] = token;
+    }
+    schedule(0, 0);
+
+    if (m_pool.on_worker()) {
+      help_until_done();
+    } else {
+      std::unique_lock<std::mutex> lock(m_done_mutex);
+      m_done.wait(lock, [this]() { return m_live == 0; });
+    }
+    std::lock_guard<std::mutex> lock(m_done_mutex);
+    return m_produced;
+  }
+
+  uint32_t max_tokens() const { return m_tokens; }
+
+ private:
+  static constexpr uint32_t kNone = UINT32_MAX;
+  // How long a helping worker sleeps when it found no task to run
+  static constexpr std::chrono::microseconds kHelpWait{100};
+
+  struct Stage {
+    Stage(StageMode stage_mode, Body stage_body, uint32_t tokens)
+        : mode(stage_mode), body(std::move(stage_body)), parked(tokens, kNone) {}
+
+    void reset() {
+      busy = false;
+      next_sequence = 0;
+      head = 0;
+      count = 0;
+      std::fill(parked.begin(), parked.end(), kNone);
+    }
+
+    const StageMode mode;
+    const Body body;
+    // Everything below is guarded by mutex
+    std::mutex mutex;
+    bool busy = false;
+    // In order: the next item to pass, waiting items are parked at their
+    // sequence number modulo the tokens. No two of them can share a slot, as
+    // every item from next_sequence on is still in flight.
+    uint64_t next_sequence = 0;
+    // Out of order: a ring of the waiting tokens, starting at head
+    std::vector<uint32_t> parked;
+    uint32_t head = 0;
+    uint32_t count = 0;
+  };
+
+  // The token, the position and whether it entered are packed into one word,
+  // so the task captures two words and fits std::function's inline storage
+  void schedule(uint32_t token, size_t position, bool entered = false) {
+    uint64_t step = (static_cast<uint64_t>(token) << 32) | (static_cast<uint64_t>(position) << 1) | entered;
+    m_pool.add_function([this, step]() {
+      advance(static_cast<uint32_t>(step >> 32), static_cast<uint32_t>(step) >> 1, (step & 1) != 0);
+    }, m_site);
+  }
+
+  // Carries the token through the stages from position on, 0 being the
+  // source, until it has to wait for a serial stage or the input ran out.
+  // entered is set when a serial stage was handed to it by the token before.
+  void advance(uint32_t token, size_t position, bool entered) {
+    while (true) {
+      if (position == 0) {
+        if (!produce(token)) {
+          return;
+        }
+      } else {
+        Stage& stage = *m_stages[position - 1];
+        if (stage.mode == StageMode::parallel) {
+          stage.body(m_items[token]);
+        } else {
+          if (!entered && !enter(stage, token)) {
+            return;
+          }
+          stage.body(m_items[token]);
+          // The next waiting token continues elsewhere, this one goes on here
+          uint32_t next = leave(stage);
+          if (next != kNone) {
+            schedule(next, position, true);
+          }
+        }
+      }
+      entered = false;
+      position = position == m_stages.size() ? 0 : position + 1;
+    }
+  }
+
+  // The worker calling run() takes on queued tasks, the stages among them,
+  // and only sleeps briefly while other workers hold all the remaining ones
+  void help_until_done() {
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(m_done_mutex);
+        if (m_live == 0) {
+          return;
+        }
+      }
+      if (!m_pool.run_one_task()) {
+        std::unique_lock<std::mutex> lock(m_done_mutex);
+        m_done.wait_for(lock, kHelpWait, [this]() { return m_live == 0; });
+      }
+    }
+  }
+
+  // Runs the source for the token, false if the token was parked or retired
+  // Retiring happens outside the lock, the pipeline may be gone right after.
+  bool produce(uint32_t token) {
+    {
+      std::unique_lock<std::mutex> lock(m_source_mutex);
+      if (m_exhausted) {
+        lock.unlock();
+        retire(1);
+        return false;
+      }
+      if (m_source_busy) {
+        m_idle[m_idle_count++] = token;
+        return false;
+      }
+      m_source_busy = true;
+    }
+
+    bool more = m_source(m_items[token]);
+
+    uint32_t next = kNone;
+    {
+      std::unique_lock<std::mutex> lock(m_source_mutex);
+      m_source_busy = false;
+      if (!more) {
+        // The idle tokens will never be needed again
+        m_exhausted = true;
+        uint32_t retired = m_idle_count + 1;
+        m_idle_count = 0;
+        lock.unlock();
+        retire(retired);
+        return false;
+      }
+      m_sequence[token] = m_produced++;
+      if (m_idle_count > 0) {
+        next = m_idle[--m_idle_count];
+      }
+    }
+    // An idle token takes over the source while this item moves on
+    if (next != kNone) {
+      schedule(next, 0);
+    }
+    return true;
+  }
+
+  // Whether the token may run the serial stage now, else it is parked
+  bool enter(Stage& stage, uint32_t token) {
+    std::lock_guard<std::mutex> lock(stage.mutex);
+    if (stage.mode == StageMode::serial_in_order) {
+      if (!stage.busy && m_sequence[token] == stage.next_sequence) {
+        stage.busy = true;
+        return true;
+      }
+      stage.parked[m_sequence[token] % m_tokens] = token;
+      return false;
+    }
+    if (!stage.busy) {
+      stage.busy = true;
+      return true;
+    }
+    stage.parked[(stage.head + stage.count++) % m_tokens] = token;
+    return false;
+  }
+
+  // Releases the serial stage, or hands it to the parked token that is next
+  uint32_t leave(Stage& stage) {
+    std::lock_guard<std::mutex> lock(stage.mutex);
+    uint32_t next = kNone;
+    if (stage.mode == StageMode::serial_in_order) {
+      uint32_t slot = static_cast<uint32_t>(++stage.next_sequence % m_tokens);
+      std::swap(next, stage.parked[slot]);
+    } else if (stage.count > 0) {
+      next = stage.parked[stage.head];
+      stage.head = (stage.head + 1) % m_tokens;
+      stage.count--;
+    }
+    stage.busy = next != kNone;
+    return next;
+  }
+
+  // The tokens are done for this run, the last one wakes run()
+  void retire(uint32_t tokens) {
+    std::lock_guard<std::mutex> lock(m_done_mutex);
+    m_live -= tokens;
+    if (m_live == 0) {
+      m_done.notify_all();
+    }
+  }
+
+  Pool& m_pool;
+  const uint32_t m_tokens;
+  Source m_source;
+  std::vector<std::unique_ptr<Stage>> m_stages;
+  TaskSite m_site;
+
+  // One item and its sequence number per token
+  std::vector<Item> m_items;
+  std::vector<uint64_t> m_sequence;
+
+  // Guarded by m_source_mutex: the tokens waiting for the source
+  std::mutex m_source_mutex;
+  bool m_source_busy = false;
+  bool m_exhausted = false;
+  uint64_t m_produced = 0;
+  std::vector<uint32_t> m_idle;
+  uint32_t m_idle_count = 0;
+
+  // Guarded by m_done_mutex: the tokens that have not retired yet
+  std::mutex m_done_mutex;
+  std::condition_variable m_done;
+  uint32_t m_live = 0;
+};
@@ -15,47 +15,310 @@
 /**
  * @author: Benrick Smit
  * @date: 20 June 2020
- * @modified: 29 December 2025
+ * @modified: 19 October 2026
  *
  * @brief: This contains the header information and interface for the Poole
- * 			class which enables concurrency in C++11/14
+ * 			class which enables concurrency in C++11/14. Poole is a typedef of
+ * 			the policy-based BasicPoole template, whose implementation lives in
+ * 			PooleImpl.h. The template relies on the Poole library for its
+ * 			non-template parts (ThreadInfo, Watchdog, TaskNodePool,
+ * 			WorkerThread, ...), so it must be linked in.
  */
 
+
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdio>
 #include <functional>
 #include <future>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <thread>
 #include <type_traits>
 #include <vector>
 
+#include "BlockingRegion.h"
+#include "CpuBudget.h"
+#include "Executor.h"
+#include "InplaceFunction.h"
+#include "LocalDeque.h"
+#include "Pipeline.h"
+#include "PooledFunction.h"
+#include "PoolePolicies.h"
+#include "PooleSampler.h"
+#include "PooleStats.h"
+#include "StatsSegment.h"
+#include "Strand.h"
 #include "ThreadInfo.h"
+#include "Watchdog.h"
+#include "WorkerArena.h"
+#include "WorkerThread.h"
+
+/**
+ * @brief A submitted task as it waits in the queues: the callable, where it
+ *          was submitted from and when, the latter only while the watchdog runs
+ */
+template <typename Task>
+struct PooleJob {
+  Task task;
+  TaskSite site;
+  uint64_t submit_ns = 0;
+};
 
-class Poole {
+/**
+ * @brief The thread pool itself, assembled from compile-time policies.
+ *
+ * @tparam Queue a QueuePolicy deciding where pending tasks are stored
+ * @tparam Idle an IdlePolicy deciding how workers wait for tasks
+ * @tparam Stats a StatsPolicy, StatsPolicy::None removes all ThreadInfo updates
+ * @tparam Task the callable type stored for every task
+ */
+template <typename Queue, typename Idle, typename Stats, typename Task>
+class BasicPoole {
  public:
+  using task_type = Task;
+  // Fills in the next task of a source, false once it has none left
+  using source_type = std::function<bool(Task& task)>;
+  using job_type = PooleJob<Task>;
+  using queue_type = typename Queue::template type<job_type>;
+  using local_queue_type = typename Queue::template local_type<job_type>;
+  using idle_type = Idle;
+
   // Ctor and Dtor
   /**
    * @brief Construct a new Poole object
+   *
+   * @param total_threads the number of workers, -1 for the CPUs the process
+   * 			may use, see CpuBudget. It is clamped to the hardware threads
+   * 			unless WorkerConfig::allow_oversubscription is set.
+   * @param config the names, stack size, priority and hooks of the workers,
+   * 			and whether they start lazily and retire when idle
    */
-  Poole(int32_t total_threads = -1);
+  BasicPoole(int32_t total_threads = -1, WorkerConfig config = WorkerConfig());
+
+  /**
+   * @brief Construct a new Poole object whose workers run hooks
+   *
+   * @param hooks callbacks every worker runs, see WorkerHooks
+   */
+  BasicPoole(int32_t total_threads, WorkerHooks hooks);
   /**
    * @brief Destroy the Poole object
    */
-  ~Poole();
+  ~BasicPoole();
+
+  /**
+   * @brief Get the pool shared by the whole process, created on first use
+   * 			with one worker per hardware thread. Its workers start as work
+   * 			arrives. Components that share it, directly or through
+   * 			make_executor(), stay within one thread budget instead of each
+   * 			oversubscribing the machine with a pool of their own.
+   *
+   * @return BasicPoole& the process-wide pool
+   */
+  static BasicPoole& global();
 
   // Main interface with the program
   /**
-   * @brief Adds a function, likely a lambda, to execute in the any thread
+   * @brief Adds a function, likely a lambda, to execute in the any thread.
+   * 			Called from a task on one of this pool's workers, the function
+   * 			goes to that worker's own deque instead, which runs the newest
+   * 			task first and which idle workers steal from.
+   *
+   * @param function_to_add is a lambda or a void function to execute
+   * @param site where the task comes from, the caller unless labelled
+   */
+  void add_function(Task function_to_add, TaskSite site = TaskSite::current());
+
+  /**
+   * @brief Adds a function without ever blocking. With a bounded queue the
+   * 			task is rejected when the queue is full.
+   *
+   * @param function_to_add is a lambda or a void function to execute
+   * @param site where the task comes from, the caller unless labelled
+   * @return true if the task was queued, false if the queue was full
+   */
+  bool try_add_function(Task function_to_add, TaskSite site = TaskSite::current());
+
+  /**
+   * @brief Adds a function to the shared queue behind everything submitted
+   * 			before it, even when called from a worker. For tasks that yield
+   * 			to the rest of the pool, e.g. a strand that ran a full batch.
+   *
+   * @param function_to_add is a lambda or a void function to execute
+   * @param site where the task comes from, the caller unless labelled
+   */
+  void add_function_shared(Task function_to_add, TaskSite site = TaskSite::current());
+
+  /**
+   * @brief Adds a source of tasks that workers pull from as they become free
+   * 			instead of every task being queued up front. At most one task
+   * 			per worker is taken from it at a time, so the queue stays small
+   * 			however many tasks the source yields. wait() returns once the
+   * 			source is exhausted and its tasks ran, a stopping pool pulls
+   * 			no more from it.
+   *
+   * @param next fills in the next task and returns true, or returns false
+   * 			once there are none left. Called by one worker at a time.
+   * @param site where the tasks come from, the caller unless labelled
+   */
+  void add_source(source_type next, TaskSite site = TaskSite::current());
+
+  /**
+   * @brief Adds a source that runs function(value) for every value in
+   * 			[first, last), read one at a time as workers become free. The
+   * 			range must stay valid until its tasks ran.
    *
+   * @param first the input, read through an input iterator
+   * @param last the end of the input
+   * @param function called with a copy of each value
+   * @param site where the tasks come from, the caller unless labelled
+   */
+  template <typename InputIt, typename Function>
+  void add_source(InputIt first, InputIt last, Function function, TaskSite site = TaskSite::current());
+
+  /**
+   * @brief Adds a function to the queue of one specific worker, so that tasks
+   * 			touching the same data run on the same core. Other workers only
+   * 			take these tasks once the worker is overloaded.
+   *
+   * @param worker_id the worker to run on, wrapped around the thread count
+   * @param function_to_add is a lambda or a void function to execute
+   * @param site where the task comes from, the caller unless labelled
+   */
+  void add_function_on(uint32_t worker_id, Task function_to_add, TaskSite site = TaskSite::current());
+
+  /**
+   * @brief Adds a function to the worker that owns the key. Every task with
+   * 			the same key goes to the same worker.
+   *
+   * @param key anything std::hash can hash, e.g. a shard number
    * @param function_to_add is a lambda or a void function to execute
+   * @param site where the task comes from, the caller unless labelled
+   */
+  template <typename Key>
+  void add_function_keyed(const Key& key, Task function_to_add, TaskSite site = TaskSite::current());
+
+  /**
+   * @brief Set how many tasks must be waiting on a worker before idle workers
+   * 			may steal them. Higher values keep more tasks on their worker.
+   *
+   * @param threshold the number of waiting tasks that marks a worker overloaded
+   */
+  void set_steal_threshold(uint32_t threshold);
+
+  /**
+   * @brief Set the most tasks a worker takes from the shared queue at once. The
+   * 			actual batch adapts to the queue depth and the idle workers, so
+   * 			this is an upper bound. 1 turns batching off.
+   *
+   * @param limit the batch limit, clamped to 1..kMaxBatch
+   */
+  void set_batch_limit(uint32_t limit);
+
+  // The largest batch a worker can hold in its private buffer
+  static constexpr uint32_t kMaxBatch = 32;
+  // The tasks a worker's own deque holds, further ones go to the shared queue
+  static constexpr uint32_t kLocalCapacity = 256;
+
+  /**
+   * @brief Get the arena of the worker running the calling task, to allocate
+   * 			short-lived containers without malloc, e.g.
+   * 			std::pmr::vector<int> values(Poole::this_worker_arena()).
+   * 			Everything allocated from it is freed after the task, so it must
+   * 			not escape the task. Other threads get the new/delete resource.
+   *
+   * @return std::pmr::memory_resource* the resource to allocate from
+   */
+  static std::pmr::memory_resource* this_worker_arena();
+
+  /**
+   * @brief Marks the calling task as blocked until the guard goes out of
+   * 			scope, e.g. around a read from disk:
+   * 			auto blocking = Poole::blocking_region();
+   * 			While it is held, the pool running the task starts or wakes
+   * 			one of its WorkerConfig::blocking_spares to keep the CPU busy.
+   *
+   * @return BlockingRegion the guard
+   */
+  static BlockingRegion blocking_region();
+
+  /**
+   * @brief Get the number of workers inside a blocking region right now
+   */
+  uint32_t get_blocked_threads();
+
+  /**
+   * @brief Get the number of spare workers that may stand in for blocked
+   * 			ones, see WorkerConfig::blocking_spares. A spare counts as a
+   * 			worker in the statistics once it has been started.
+   */
+  uint32_t get_spare_threads();
+
+  /**
+   * @brief Creates a strand on this pool. Tasks added to one strand run one at a
+   * 			time and in order, yet on any worker, while different strands
+   * 			run in parallel. Useful for per-connection ordering without locks.
+   *
+   * @return BasicStrand<BasicPoole> a handle that can be copied freely
+   */
+  BasicStrand<BasicPoole> make_strand();
+
+  /**
+   * @brief Get a named executor on this pool. The executors of a pool share
+   * 			its workers by weight: while several have work, each gets
+   * 			worker time in proportion to its weight, and an executor
+   * 			alone gets every worker. Asking again for a name returns the
+   * 			same executor with the new weight.
+   *
+   * @param name identifies the executor, e.g. the component using it
+   * @param weight its share relative to the other executors, at least 1
+   * @return BasicExecutor<BasicPoole> a handle that must not outlive the pool
+   */
+  BasicExecutor<BasicPoole> make_executor(const std::string& name, uint32_t weight = 1);
+
+  /**
+   * @brief Get the tasks run, tasks waiting and run time of every executor
    */
-  void add_function(std::function<void()> function_to_add);
+  std::vector<ExecutorStats> get_executor_stats();
+
+  /**
+   * @brief Applies function to every input on the workers and writes the
+   * 			results to out in input order, like std::transform. The input
+   * 			is read once, front to back, and only window inputs are in
+   * 			flight at once, each in a slot allocated up front, so a stream
+   * 			of any length needs the same memory. Returns once every result
+   * 			is written. Called from a task, the worker runs queued tasks
+   * 			meanwhile, so it works on a pool with a single worker too.
+   * 			A random access out, e.g. into a vector sized up front, gets
+   * 			every result assigned straight to its element. Any other out
+   * 			can only be written in order, so each result waits in its slot
+   * 			until the results before it were written.
+   *
+   * @param first the input, read through an input iterator
+   * @param last the end of the input
+   * @param function called as function(input) on several workers at once
+   * @param out receives the results, at a random access out from several
+   * 			tasks at once, else from one task at a time
+   * @param window the most inputs in flight, 0 for kMapWindowPerWorker per worker
+   * @param site where the tasks come from, the caller unless labelled
+   * @return OutputIt past the last result written
+   */
+  template <typename InputIt, typename OutputIt, typename Function>
+  OutputIt parallel_map_ordered(InputIt first, InputIt last, Function function, OutputIt out,
+      uint32_t window = 0, TaskSite site = TaskSite::current());
+
+  // The default window of parallel_map_ordered, in inputs per worker
+  static constexpr uint32_t kMapWindowPerWorker = 4;
 
   /**
    * @brief This function pauses the execution of the threads even if jobs are available
@@ -96,7 +359,50 @@ class Poole {
    */
   uint32_t get_possible_threads();
 
+  /**
+   * @brief Get the number of workers that have a thread right now. Always
+   * 			get_possible_threads() unless WorkerConfig::lazy_spawn or an
+   * 			idle_timeout is set.
+   *
+   * @return uint32_t the number of running worker threads
+   */
+  uint32_t get_live_threads();
+
+  /**
+   * @brief Limits the workers that take shared and stolen tasks, the others
+   * 			only run tasks pinned to them and otherwise sleep. Workers
+   * 			0..threads-1 stay active.
+   *
+   * @param threads the active workers, clamped to 1..get_possible_threads()
+   */
+  void set_active_threads(uint32_t threads);
+
+  /**
+   * @brief Get the number of workers that take shared and stolen tasks
+   */
+  uint32_t get_active_threads();
+
+  /**
+   * @brief Polls the CPU throttling counters of the process's cgroup every
+   * 			interval and lowers the active workers while the CPU quota keeps
+   * 			running out, raising them again once it stops, never above the
+   * 			active workers when watching started. See ThrottleWatch.
+   *
+   * @param interval the time between two polls
+   * @param budget where the counters are read, the calling process by default
+   * @return true if the cgroup has throttling counters to watch
+   */
+  bool watch_cpu_throttling(std::chrono::milliseconds interval = std::chrono::milliseconds(1000),
+      CpuBudget budget = CpuBudget());
+
+  /**
+   * @brief Stops watching. If the watch lowered the active workers, they
+   * 			are set back to what they were when watching started.
+   */
+  void stop_watching_cpu_throttling();
+
   // Thread Information
+  // With StatsPolicy::None no statistics are kept and these return zeros.
   /**
    * @brief Get the total tasks executed per thread as a vector
    *
@@ -125,6 +431,99 @@ class Poole {
    */
   uint64_t get_total_uptime();
 
+  /**
+   * @brief Get the share of each thread's time spent running tasks, the rest
+   * 			was spent looking for work or parked
+   *
+   * @return std::vector<double> a ratio between 0 and 1 per thread
+   */
+  std::vector<double> get_thread_utilization();
+
+  /**
+   * @brief Get the CPU time used by each thread, read from its
+   * 			CLOCK_THREAD_CPUTIME_ID clock
+   *
+   * @return std::vector<uint64_t> the CPU time per thread in nanoseconds
+   */
+  std::vector<uint64_t> get_thread_cpu_time();
+
+  /**
+   * @brief Get the share of the time all threads together spent running tasks
+   *
+   * @return double a ratio between 0 and 1
+   */
+  double get_total_utilization();
+
+  /**
+   * @brief Get the number of pinned or locally submitted tasks that were run by
+   * 			another worker
+   *
+   * @return uint64_t the number of stolen tasks
+   */
+  uint64_t get_total_tasks_stolen();
+
+  /**
+   * @brief Get the number of submitted tasks whose closure was too big to be
+   * 			stored inline and took a TaskNodePool node, and the bytes they
+   * 			took. Only PooledFunction tasks are counted.
+   */
+  uint64_t get_total_task_allocations();
+  uint64_t get_total_task_allocated_bytes();
+
+  // Gauges, these are kept even with StatsPolicy::None
+  /**
+   * @brief Get the number of tasks submitted that have not started yet
+   *
+   * @return uint64_t the current backlog of the pool
+   */
+  uint64_t get_pending_tasks();
+
+  /**
+   * @brief Get the number of tasks that are running right now
+   */
+  uint64_t get_running_tasks();
+
+  /**
+   * @brief Get the deepest the shared queue, or the pinned queue of any
+   * 			worker, has been since construction or the last reset
+   */
+  uint64_t get_peak_pending_tasks();
+
+  /**
+   * @brief Resets the peak queue depth, e.g. at the start of a new window
+   *
+   * @return uint64_t the peak before the reset
+   */
+  uint64_t reset_peak_pending_tasks();
+
+  /**
+   * @brief Starts recording the throughput, backlog and estimated wait time
+   * 			every period on a sampling thread, keeping the last window
+   * 			samples. Calling it again starts a new recording.
+   *
+   * @param period the time between two samples
+   * @param window the number of samples kept
+   */
+  void start_sampling(std::chrono::milliseconds period = std::chrono::milliseconds(1000),
+      std::size_t window = 60);
+
+  /**
+   * @brief Stops recording and drops the samples
+   */
+  void stop_sampling();
+
+  /**
+   * @brief Get the recorded samples, oldest first, empty when not sampling
+   */
+  std::vector<PooleSample> get_samples();
+
+  /**
+   * @brief Get the number of times a worker was woken up and found no work
+   *
+   * @return uint64_t the number of spurious wake-ups
+   */
+  uint64_t get_total_spurious_wakeups();
+
   /**
    * @brief creates a string of statistics to display the information per thread
    *
@@ -132,16 +531,180 @@ class Poole {
    */
   std::string statistics();
 
+  /**
+   * @brief Takes a snapshot of the statistics without stopping the workers.
+   * 			Every worker is read consistently, and reusing the same
+   * 			snapshot avoids allocating once its worker list has grown.
+   *
+   * @param stats receives the statistics
+   */
+  void snapshot(PooleStats& stats);
+
+  /**
+   * @brief Takes a snapshot of the statistics into a new PooleStats
+   */
+  PooleStats snapshot();
+
+  /**
+   * @brief Publishes a snapshot into a shared-memory segment at path every
+   * 			interval, for poole-top or any other StatsSegment::Reader. The
+   * 			sampling runs on its own thread. Calling it again moves the
+   * 			segment, and it is removed when the pool is destroyed.
+   *
+   * @param path the file to create, e.g. under /dev/shm
+   * @param interval the time between two publications
+   * @return true if the segment was created
+   */
+  bool publish_stats(const std::string& path,
+      std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+
+  /**
+   * @brief Stops publishing and removes the segment
+   */
+  void stop_publishing_stats();
+
+  /**
+   * @brief Starts flagging tasks that run or wait longer than the configured
+   * 			thresholds. Flagged tasks are totalled per callsite, and a
+   * 			task that is still running is reported before it finishes.
+   * 			Calling it again replaces the configuration.
+   *
+   * @param config the thresholds and an optional callback per flagged task
+   */
+  void enable_watchdog(const WatchdogConfig& config = WatchdogConfig());
+
+  /**
+   * @brief Stops the watchdog, its report is kept
+   */
+  void disable_watchdog();
+
+  /**
+   * @brief Get the flagged tasks totalled per callsite
+   */
+  std::vector<CallsiteReport> get_watchdog_report();
+
  private:
   // Delete certain functions
-  Poole(const Poole*) = delete;
-  Poole(const Poole&&) = delete;
+  BasicPoole(const BasicPoole&) = delete;
+  BasicPoole(BasicPoole&&) = delete;
+  BasicPoole& operator=(const BasicPoole&) = delete;
+  BasicPoole& operator=(BasicPoole&&) = delete;
+
+  /**
+   * @brief Tells the pool when a task on the worker enters and leaves a
+   * 			BlockingRegion
+   */
+  struct BlockingHandler final : BlockingRegion::Handler {
+    void enter() override { pool->enter_blocking(); }
+    void leave() override { pool->leave_blocking(); }
+
+    BasicPoole* pool = nullptr;
+  };
+
+  /**
+   * @brief Everything a worker owns. Aligned to a cache line so that workers
+   * 			do not slow each other down through false sharing.
+   */
+  struct alignas(64) Worker {
+    explicit Worker(uint32_t total_workers)
+        : pinned(total_workers), pinned_pending(0), local(kLocalCapacity), batch(new job_type[kMaxBatch]) {}
+
+    local_queue_type pinned;
+    std::atomic<uint64_t> pinned_pending;
+    // Tasks submitted by the tasks of this worker, newest first
+    LocalDeque<job_type> local;
+    std::atomic<uint64_t> local_pending{0};
+    // Tasks taken from the shared queue in one go, only touched by the owner
+    std::unique_ptr<job_type[]> batch;
+    uint32_t batch_head = 0;
+    uint32_t batch_size = 0;
+    // Rewound after every task, only touched by the owner
+    WorkerArena arena;
+    // The tasks running on the owner, more than one while a task helps with
+    // the queue, see run_one_task()
+    uint32_t depth = 0;
+    // Whether the worker has a thread, changed under m_spawn_mutex
+    std::atomic<bool> alive{false};
+    BlockingHandler blocking;
+    // Written by the owner around every task, on their own cache line so
+    // submitters touching pinned_pending do not contend with them
+    alignas(64) std::atomic<uint32_t> running{0};
+    std::atomic<uint64_t> completed{0};
+  };
 
   // Initialise the threads and the exit condition
+  /**
+   * @brief Works out how many threads to create for the requested number
+   */
+  static uint32_t resolve_threads(int32_t total_threads, bool allow_oversubscription);
+
+  /**
+   * @brief Get the number of workers including the blocking spares, which
+   * 			follow the regular workers
+   */
+  uint32_t worker_slots() const;
+
+  /**
+   * @brief Get the number of slots that ever had a thread, the regular
+   * 			workers and the spares started so far. Spares start in order, so
+   * 			these are the first slots.
+   */
+  uint32_t started_slots() const;
+
+  /**
+   * @brief Whether the worker may take shared and stolen tasks: a regular
+   * 			worker below the active limit, or a spare standing in for a
+   * 			blocked worker
+   */
+  bool is_active(uint32_t thread_id) const;
+
+  /**
+   * @brief Get the number of spares standing in for blocked workers
+   */
+  uint32_t active_spares() const;
+
+  /**
+   * @brief Called when a task of a worker enters and leaves a blocking region
+   */
+  void enter_blocking();
+  void leave_blocking();
+
   /**
    * @brief setup all the member variables correctly.
    */
-  void init(int32_t total_threads);
+  void init();
+
+  /**
+   * @brief Starts the thread of a worker that has none, joining the thread
+   * 			that ran it before. m_spawn_mutex must be held.
+   */
+  void spawn_worker_locked(uint32_t thread_id);
+
+  /**
+   * @brief Starts another worker for a lazy pool when the backlog is larger
+   * 			than the workers sleeping on it
+   *
+   * @param backlog the depth of the queue the task was just pushed onto
+   */
+  void maybe_spawn(uint64_t backlog);
+
+  /**
+   * @brief Makes sure a worker has a thread before a task is pinned to it
+   */
+  void ensure_worker(uint32_t thread_id);
+
+  /**
+   * @brief Lets a worker that idled past the timeout exit. Fails when work
+   * 			arrived meanwhile or the pool is stopping or paused.
+   *
+   * @return true if the worker must leave zombie_loop
+   */
+  bool retire(uint32_t thread_id);
+
+  /**
+   * @brief Runs the stop hook and detaches the worker from its thread
+   */
+  void exit_worker(uint32_t thread_id);
 
   /**
    * @brief This the infinite loop that looks for jobs to execute per thread
@@ -150,6 +713,143 @@ class Poole {
    */
   void zombie_loop(uint32_t thread_id = 0);
 
+  /**
+   * @brief Runs one task on the given worker and does the bookkeeping around it
+   */
+  void execute(uint32_t thread_id, job_type& job);
+
+  /**
+   * @brief Takes the next task for a worker: its own pinned tasks first, then
+   * 			the shared queue, then tasks stolen from an overloaded worker
+   */
+  bool take_task(uint32_t thread_id, job_type& job);
+
+  /**
+   * @brief Whether the worker is overloaded enough for others to steal from it
+   */
+  bool is_stealable(const Worker& worker) const;
+
+  /**
+   * @brief Raises the peak queue depth if depth exceeds it
+   */
+  void update_peak_pending(uint64_t depth);
+
+  /**
+   * @brief Get the number of tasks finished, counted even without statistics
+   */
+  uint64_t get_completed_tasks() const;
+
+  /**
+   * @brief Works out how many tasks to take from the shared queue at once
+   */
+  uint32_t batch_size() const;
+
+  /**
+   * @brief Blocks the submitter until the queue has room for the task
+   */
+  template <typename TaskQueue>
+  void wait_for_space(TaskQueue& queue, job_type& job);
+
+  /**
+   * @brief Pushes onto the deque of the calling worker, if it is one of ours
+   *
+   * @return false if the caller is not our worker or its deque is full, in
+   * 			which case the job is left untouched
+   */
+  bool push_local(job_type& job);
+
+  /**
+   * @brief Pushes onto the shared queue, waiting for room if it is bounded
+   */
+  void push_shared(job_type& job);
+
+  /**
+   * @brief Wraps a task for the queues, timestamped while the watchdog runs
+   */
+  job_type make_job(Task&& function_to_add, const TaskSite& site);
+
+  // Strands and executors run their tasks inside relay tasks of their own,
+  // pipelines help with the queue while they wait
+  template <typename> friend class BasicStrand;
+  template <typename> friend class BasicExecutorGroup;
+  template <typename, typename> friend class BasicPipeline;
+
+  /**
+   * @brief Whether the calling thread is one of our workers
+   */
+  bool on_worker() const;
+
+  /**
+   * @brief Runs the next task the calling worker would take, nested in the
+   * 			task that called it. For tasks that wait on work queued behind
+   * 			them, which would otherwise wait forever on a pool without a
+   * 			free worker.
+   *
+   * @return false if there was none or the caller is not our worker
+   */
+  bool run_one_task();
+
+  /**
+   * @brief Lets a submitter blocked on a full queue retry once a task left it
+   */
+  void release_space();
+
+  /**
+   * @brief Get the submission time to keep with a task, 0 unless the
+   * 			watchdog will look at it
+   */
+  uint64_t submit_time_ns() const;
+
+  /**
+   * @brief Runs function on the calling worker as a task of its own, seen
+   * 			by the watchdog and the hooks under site. Off our workers it is
+   * 			only called.
+   */
+  template <typename Function>
+  void run_as(const TaskSite& site, uint64_t submit_ns, Function& function);
+
+  /**
+   * @brief A source added with add_source(), shared by the tasks pulling it
+   */
+  struct TaskSource {
+    std::mutex mutex;
+    source_type next;
+    bool exhausted = false;
+    TaskSite site;
+  };
+
+  /**
+   * @brief Queues a task that pulls the next task of the source, requeues
+   * 			itself and then runs what it pulled. Bypasses the stop check of
+   * 			add_function_shared(), a stopping pool ends its pulls instead.
+   *
+   * @param may_wait whether to wait for room in a full bounded queue, never
+   * 			on a worker
+   * @return false if the queue was full and may_wait unset
+   */
+  bool schedule_pull(const std::shared_ptr<TaskSource>& source, bool may_wait);
+  void pull(const std::shared_ptr<TaskSource>& source);
+
+  /**
+   * @brief Wakes one sleeping worker that may take shared tasks
+   */
+  void wake_one();
+
+  /**
+   * @brief Marks one submitted task as finished and wakes wait() after the last
+   */
+  void finish_task();
+
+  /**
+   * @brief The condition a sleeping worker waits for
+   */
+  bool has_work(uint32_t thread_id) const;
+
+  /**
+   * @brief Get the number of tasks waiting in the shared and pinned queues
+   */
+  uint64_t get_queued_tasks() const;
+
   /**
    * @brief This function is used to stop the thread pool dead in its tracks
    *
@@ -163,14 +863,77 @@ class Poole {
   void set_possible_threads(uint32_t possible_threads);
 
   // Member Variables
-  std::vector<std::thread> m_threads;
-  std::vector<ThreadInfo> m_thread_info;
-  std::queue<std::function<void()>> m_function_queue;
-  std::mutex m_queue_mutex;
-  std::condition_variable m_threadpool_notifier;
-  std::condition_variable m_wait_execution_notifier;
   uint32_t m_total_possible_threads;
-  bool m_stop_processing;
-  bool m_emergency_stop;
-  bool m_paused;
+  const uint32_t m_spare_threads;
+  std::vector<WorkerThread> m_threads;
+  std::vector<std::unique_ptr<ThreadInfo>> m_thread_info;
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  queue_type m_function_queue;
+  Idle m_idle;
+  std::mutex m_wait_mutex;
+  // Serialises starting and retiring workers
+  std::mutex m_spawn_mutex;
+  std::condition_variable m_wait_execution_notifier;
+  std::condition_variable m_space_notifier;
+  std::atomic<uint32_t> m_blocked_producers;
+  // Tasks sitting in the shared queue, and tasks submitted but not yet finished
+  std::atomic<uint64_t> m_pending;
+  std::atomic<uint64_t> m_outstanding;
+  std::atomic<uint64_t> m_stolen;
+  std::atomic<uint64_t> m_peak_pending;
+  std::atomic<uint64_t> m_task_allocations;
+  std::atomic<uint64_t> m_task_allocated_bytes;
+  std::atomic<uint32_t> m_steal_threshold;
+  std::atomic<uint32_t> m_batch_limit;
+  std::atomic<uint32_t> m_live_workers;
+  std::atomic<uint32_t> m_active_workers;
+  std::atomic<uint32_t> m_blocked_workers;
+  // How many of the spares have been started, only grows
+  std::atomic<uint32_t> m_started_spares;
+  std::atomic<bool> m_stop_processing;
+  std::atomic<bool> m_emergency_stop;
+  std::atomic<bool> m_paused;
+  Watchdog m_watchdog;
+  const WorkerConfig m_worker_config;
+  const WorkerHooks& m_hooks;
+  // Created with the pool so that executors can be handed out at any time
+  BasicExecutorGroup<BasicPoole> m_executors;
+
+  // The pool and worker running on this thread, set by zombie_loop
+  static inline thread_local const BasicPoole* t_current_pool = nullptr;
+  static inline thread_local uint32_t t_current_worker = 0;
+
+  // Created by publish_stats(), it samples the pool from its own thread
+  std::unique_ptr<StatsSegment::Publisher> m_stats_publisher;
+  // Created by start_sampling()
+  std::unique_ptr<PooleSampler> m_sampler;
+  // Created by watch_cpu_throttling(), with the active workers it started
+  // from and whether it changed them since
+  std::unique_ptr<ThrottleWatch> m_throttle_watch;
+  uint32_t m_throttle_restore = 0;
+  bool m_throttle_applied = false;
 };
+
+/**
+ * @brief The default pool: one FIFO queue, workers parked on their own futex
+ *          slot, full per-thread statistics and PooledFunction tasks, which
+ *          keep closures too big to store inline in recycled nodes.
+ */
+using Poole = BasicPoole<QueuePolicy::Fifo, IdlePolicy::Futex, StatsPolicy::Full,
+    PooledFunction<>>;
+
+/**
+ * @brief A pool for real-time submitters. The task slots, the worker storage and
+ *          the statistics are all allocated in the constructor, after which
+ *          submitting, dispatching and completing tasks never touch the heap.
+ *          Tasks are stored inline, so a lambda capturing more than TaskBytes
+ *          is rejected at compile time.
+ *
+ * @tparam Capacity the maximum number of pending tasks
+ * @tparam TaskBytes the inline storage available to every task
+ */
+template <std::size_t Capacity = 1024, std::size_t TaskBytes = 64>
+using RealtimePoole = BasicPoole<QueuePolicy::Bounded<Capacity>, IdlePolicy::Futex,
+    StatsPolicy::Full, InplaceFunction<TaskBytes>>;
+
+#include "PooleImpl.h"
@@ -0,0 +1,1426 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+*/
+/**
+ * @author: Benrick Smit
+ * @email: metatronicprogramming@hotmail.com
+ * @date: 20 June 2020
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains the implementation of the BasicPoole class template for
+ *          concurrency in c++11/14. It is included at the bottom of Poole.h and
+ *          should not be included on its own.
+ *
+ */
+
+#pragma once
+
+#include "Poole.h"
+
+#define POOLE_TEMPLATE template <typename Queue, typename Idle, typename Stats, typename Task>
+#define POOLE_TYPE BasicPoole<Queue, Idle, Stats, Task>
+
+// The Constructor creates the Threads and sets some objects used by the pool
+POOLE_TEMPLATE
+POOLE_TYPE::BasicPoole(int32_t total_threads, WorkerConfig config)
+    : m_total_possible_threads(resolve_threads(total_threads, config.allow_oversubscription)),
+      m_spare_threads(config.blocking_spares == WorkerConfig::kSparePerWorker
+              ? m_total_possible_threads : config.blocking_spares),
+      m_function_queue(m_total_possible_threads),
+      m_idle(m_total_possible_threads + m_spare_threads),
+      m_blocked_producers(0),
+      m_pending(0),
+      m_outstanding(0),
+      m_stolen(0),
+      m_peak_pending(0),
+      m_task_allocations(0),
+      m_task_allocated_bytes(0),
+      m_steal_threshold(4),
+      m_batch_limit(kMaxBatch),
+      m_live_workers(0),
+      m_active_workers(m_total_possible_threads),
+      m_blocked_workers(0),
+      m_started_spares(0),
+      m_stop_processing(false),
+      m_emergency_stop(false),
+      m_paused(false),
+      m_watchdog(m_total_possible_threads + m_spare_threads),
+      m_worker_config(std::move(config)),
+      m_hooks(m_worker_config.hooks),
+      m_executors(*this) {
+    init();
+}
+
+POOLE_TEMPLATE
+POOLE_TYPE::BasicPoole(int32_t total_threads, WorkerHooks hooks)
+    : BasicPoole(total_threads, [&hooks](){
+          WorkerConfig config;
+          config.hooks = std::move(hooks);
+          return config;
+      }()) {}
+
+// The Deconstructor uses the same method as the force_shutdown method and joins all threads
+POOLE_TEMPLATE
+POOLE_TYPE::~BasicPoole(){
+    // Stop sampling before the workers go away, then finish the thread execution
+    stop_publishing_stats();
+    stop_sampling();
+    // No point in restoring the active workers of a pool going away
+    m_throttle_watch.reset();
+    disable_watchdog();
+    force_stop();
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::add_function(Task function_to_add, TaskSite site) {
+    // Make sure that you can't add functions if the function is
+    // pool is stopped, or exited
+    if (m_stop_processing || m_emergency_stop){
+        std::cerr << "ERROR: Poole::add_function() - attempted to add function to stopepd pool.";
+        exit(1);
+    }
+
+    // Count the task before it becomes visible so wait() can never miss it
+    m_outstanding.fetch_add(1);
+
+    // A task submitting work keeps it on its own worker when there is room
+    job_type job = make_job(std::move(function_to_add), site);
+    if (!push_local(job)){
+        push_shared(job);
+    }
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::add_function_shared(Task function_to_add, TaskSite site) {
+    if (m_stop_processing || m_emergency_stop){
+        std::cerr << "ERROR: Poole::add_function_shared() - attempted to add function to stopepd pool.";
+        exit(1);
+    }
+
+    m_outstanding.fetch_add(1);
+    job_type job = make_job(std::move(function_to_add), site);
+    push_shared(job);
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::add_source(source_type next, TaskSite site) {
+    if (m_stop_processing || m_emergency_stop){
+        std::cerr << "ERROR: Poole::add_source() - attempted to add source to stopped pool.";
+        exit(1);
+    }
+
+    // One pull per worker keeps every worker busy, each pull requeues itself
+    // so the number queued never grows. The pulls are relays, the tasks they
+    // run are reported and counted under the source's site.
+    auto source = std::make_shared<TaskSource>();
+    source->next = std::move(next);
+    source->site = site;
+    uint32_t scheduled = 0;
+    while (scheduled < get_possible_threads() && schedule_pull(source, !on_worker())){
+        scheduled++;
+    }
+
+    // A worker must not wait for room in a full bounded queue, nothing might
+    // drain it. It pulls the source itself instead.
+    if (scheduled == 0){
+        pull(source);
+    }
+}
+
+POOLE_TEMPLATE
+template <typename InputIt, typename Function>
+void POOLE_TYPE::add_source(InputIt first, InputIt last, Function function, TaskSite site) {
+    // The tasks share the function instead of each holding a copy
+    auto shared_function = std::make_shared<Function>(std::move(function));
+    add_source([first, last, shared_function](Task& task) mutable {
+        if (first == last){
+            return false;
+        }
+        task = [shared_function, value = *first]() mutable { (*shared_function)(value); };
+        ++first;
+        return true;
+    }, site);
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::schedule_pull(const std::shared_ptr<TaskSource>& source, bool may_wait) {
+    m_outstanding.fetch_add(1);
+    job_type job = make_job([this, source]() { pull(source); }, TaskSite::relayed(source->site));
+    if (may_wait){
+        push_shared(job);
+        return true;
+    }
+    if (!m_function_queue.push(std::move(job))){
+        // Rejected, so it no longer counts towards wait()
+        finish_task();
+        return false;
+    }
+    uint64_t backlog = m_pending.fetch_add(1) + 1;
+    update_peak_pending(backlog);
+    wake_one();
+    maybe_spawn(backlog);
+    return true;
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::pull(const std::shared_ptr<TaskSource>& source) {
+    while (true){
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(source->mutex);
+            if (source->exhausted || m_stop_processing.load() || m_emergency_stop.load()){
+                return;
+            }
+            if (!source->next(task)){
+                source->exhausted = true;
+                return;
+            }
+        }
+        // Queued behind the rest of the pool's work, so sources do not starve
+        // tasks added directly. This pull still counts, so wait() cannot
+        // return between the two. When a bounded queue is full the worker
+        // keeps pulling here instead of waiting for room.
+        bool requeued = schedule_pull(source, false);
+        run_as(source->site, 0, task);
+        if (requeued){
+            return;
+        }
+    }
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::push_shared(job_type& job) {
+    // Add the function to the queue, waiting for room if it is bounded
+    if (!m_function_queue.push(std::move(job))){
+        wait_for_space(m_function_queue, job);
+    }
+    uint64_t backlog = m_pending.fetch_add(1) + 1;
+    update_peak_pending(backlog);
+
+    // Notify one thread in the thread pool that a function has been added
+    wake_one();
+    maybe_spawn(backlog);
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::push_local(job_type& job) {
+    if (t_current_pool != this){
+        return false;
+    }
+    Worker& worker = *m_workers[t_current_worker];
+    if (!worker.local.push(std::move(job))){
+        return false;
+    }
+    uint64_t backlog = worker.local_pending.fetch_add(1) + 1;
+    update_peak_pending(backlog);
+
+    // The owner runs it after its current task, but a sleeping worker may
+    // steal it right away. Free when nobody sleeps.
+    wake_one();
+    maybe_spawn(backlog);
+    return true;
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::add_function_on(uint32_t worker_id, Task function_to_add, TaskSite site) {
+    if (m_stop_processing || m_emergency_stop){
+        std::cerr << "ERROR: Poole::add_function_on() - attempted to add function to stopepd pool.";
+        exit(1);
+    }
+
+    Worker& worker = *m_workers[worker_id % get_possible_threads()];
+
+    m_outstanding.fetch_add(1);
+    job_type job = make_job(std::move(function_to_add), site);
+    if (!worker.pinned.push(std::move(job))){
+        wait_for_space(worker.pinned, job);
+    }
+    uint64_t waiting = worker.pinned_pending.fetch_add(1) + 1;
+    update_peak_pending(waiting);
+    ensure_worker(worker_id % get_possible_threads());
+
+    // Wake the owner, and once it is overloaded anyone who may steal
+    if (waiting > m_steal_threshold.load()){
+        wake_one();
+    }
+    m_idle.notify(worker_id % get_possible_threads());
+}
+
+POOLE_TEMPLATE
+template <typename Key>
+void POOLE_TYPE::add_function_keyed(const Key& key, Task function_to_add, TaskSite site) {
+    // Mix the hash, std::hash of an integer is usually the integer itself and
+    // would put neighbouring keys on neighbouring workers only by accident
+    uint64_t hash = static_cast<uint64_t>(std::hash<Key>{}(key)) * 0x9E3779B97F4A7C15ull;
+    uint32_t worker_id = static_cast<uint32_t>((hash >> 32) % get_possible_threads());
+    add_function_on(worker_id, std::move(function_to_add), site);
+}
+
+POOLE_TEMPLATE
+template <typename InputIt, typename OutputIt, typename Function>
+OutputIt POOLE_TYPE::parallel_map_ordered(InputIt first, InputIt last, Function function, OutputIt out,
+        uint32_t window, TaskSite site) {
+    using Input = typename std::iterator_traits<InputIt>::value_type;
+    using Result = std::decay_t<std::invoke_result_t<Function&, const Input&>>;
+    static_assert(!std::is_void_v<Result>, "parallel_map_ordered() needs a function that returns a value");
+
+    // A slot holds an input until it is mapped, its position in the input
+    // and, for an output written in order, its result until written
+    struct Slot {
+        std::optional<Input> input;
+        std::optional<Result> result;
+        uint64_t index = 0;
+    };
+    if (window == 0){
+        window = kMapWindowPerWorker * get_possible_threads();
+    }
+
+    // The pipeline only lets a slot read the next input once it is done with
+    // the last, which bounds the memory to the window
+    uint64_t next = 0;
+    BasicPipeline<BasicPoole, Slot> pipeline(*this, window);
+    pipeline.source([&first, &last, &next](Slot& slot){
+        if (first == last){
+            return false;
+        }
+        slot.input.emplace(*first);
+        slot.index = next++;
+        ++first;
+        return true;
+    });
+
+    using Category = typename std::iterator_traits<OutputIt>::iterator_category;
+    if constexpr (std::is_base_of_v<std::random_access_iterator_tag, Category>){
+        // The output is sized up front, every result goes straight into the
+        // element at its input's position
+        pipeline.stage(StageMode::parallel, [&function, &out](Slot& slot){
+            out[static_cast<typename std::iterator_traits<OutputIt>::difference_type>(slot.index)]
+                    = function(*slot.input);
+            slot.input.reset();
+        });
+        uint64_t produced = pipeline.run(site);
+        return out + static_cast<typename std::iterator_traits<OutputIt>::difference_type>(produced);
+    } else{
+        // Anything else, e.g. a back_inserter or a stream, can only be written
+        // front to back, so a result waits in its slot until it is its turn
+        pipeline
+            .stage(StageMode::parallel, [&function](Slot& slot){
+                slot.result.emplace(function(*slot.input));
+                slot.input.reset();
+            })
+            .stage(StageMode::serial_in_order, [&out](Slot& slot){
+                *out = std::move(*slot.result);
+                ++out;
+                slot.result.reset();
+            });
+        pipeline.run(site);
+        return out;
+    }
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::set_steal_threshold(uint32_t threshold) {
+    m_steal_threshold = threshold;
+    // Workers may now be allowed to steal tasks they previously had to leave
+    m_idle.notify_all();
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::try_add_function(Task function_to_add, TaskSite site) {
+    if (m_stop_processing || m_emergency_stop){
+        std::cerr << "ERROR: Poole::try_add_function() - attempted to add function to stopepd pool.";
+        exit(1);
+    }
+
+    m_outstanding.fetch_add(1);
+    job_type job = make_job(std::move(function_to_add), site);
+    if (push_local(job)){
+        return true;
+    }
+    if (!m_function_queue.push(std::move(job))){
+        // Rejected, so it no longer counts towards wait()
+        finish_task();
+        return false;
+    }
+    uint64_t backlog = m_pending.fetch_add(1) + 1;
+    update_peak_pending(backlog);
+
+    wake_one();
+    maybe_spawn(backlog);
+    return true;
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::set_batch_limit(uint32_t limit) {
+    m_batch_limit = std::max(1u, std::min(limit, kMaxBatch));
+}
+
+POOLE_TEMPLATE
+std::pmr::memory_resource* POOLE_TYPE::this_worker_arena() {
+    return WorkerArena::current();
+}
+
+POOLE_TEMPLATE
+POOLE_TYPE& POOLE_TYPE::global() {
+    // A function-local static is created once even with concurrent callers,
+    // and every translation unit shares it
+    static BasicPoole pool(-1, [](){
+        WorkerConfig config;
+        config.lazy_spawn = true;
+        config.blocking_spares = WorkerConfig::kSparePerWorker;
+        return config;
+    }());
+    return pool;
+}
+
+POOLE_TEMPLATE
+BasicStrand<POOLE_TYPE> POOLE_TYPE::make_strand() {
+    return BasicStrand<BasicPoole>(*this);
+}
+
+POOLE_TEMPLATE
+BasicExecutor<POOLE_TYPE> POOLE_TYPE::make_executor(const std::string& name, uint32_t weight) {
+    return m_executors.get(name, weight);
+}
+
+POOLE_TEMPLATE
+std::vector<ExecutorStats> POOLE_TYPE::get_executor_stats() {
+    return m_executors.stats();
+}
+
+POOLE_TEMPLATE
+template <typename TaskQueue>
+void POOLE_TYPE::wait_for_space(TaskQueue& queue, job_type& job) {
+    // Register as blocked before retrying, a worker that pops after the retry
+    // is then guaranteed to see the registration and wake us
+    std::unique_lock<std::mutex> wait_lock(m_wait_mutex);
+    m_blocked_producers.fetch_add(1);
+    m_space_notifier.wait(
+        wait_lock,
+        [&queue, &job](){
+            return queue.push(std::move(job));
+        });
+    m_blocked_producers.fetch_sub(1);
+}
+
+POOLE_TEMPLATE
+typename POOLE_TYPE::job_type POOLE_TYPE::make_job(Task&& function_to_add, const TaskSite& site) {
+    // Only closures that did not fit inline touch the shared counters
+    if (std::size_t bytes = poole_task_heap_bytes(function_to_add)){
+        m_task_allocations.fetch_add(1, std::memory_order_relaxed);
+        m_task_allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    return job_type{std::move(function_to_add), site, submit_time_ns()};
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::on_worker() const {
+    return t_current_pool == this;
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::run_one_task() {
+    if (!on_worker() || (m_paused.load() && !m_stop_processing.load())){
+        return false;
+    }
+    uint32_t thread_id = t_current_worker;
+    job_type job;
+    if (!take_task(thread_id, job)){
+        return false;
+    }
+    release_space();
+    execute(thread_id, job);
+    return true;
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::release_space() {
+    // A slot was freed, let a submitter blocked on a full queue retry
+    if (m_blocked_producers.load() > 0){
+        { std::lock_guard<std::mutex> wait_lock(m_wait_mutex); }
+        m_space_notifier.notify_all();
+    }
+}
+
+POOLE_TEMPLATE
+uint64_t POOLE_TYPE::submit_time_ns() const {
+    // Only read the clock when the watchdog will look at the wait
+    return m_watchdog.enabled() ? Watchdog::now_ns() : 0;
+}
+
+POOLE_TEMPLATE
+template <typename Function>
+void POOLE_TYPE::run_as(const TaskSite& site, uint64_t submit_ns, Function& function) {
+    if (t_current_pool != this){
+        function();
+        return;
+    }
+    uint32_t thread_id = t_current_worker;
+    Worker& worker = *m_workers[thread_id];
+    bool watched = m_watchdog.enabled();
+    // A task run while another waits on it, e.g. by a pipeline helping out,
+    // borrows the worker's slot. The outer task gets it back afterwards.
+    bool nested = watched && worker.depth > 1;
+    Watchdog::Suspended outer;
+    if (nested){
+        outer = m_watchdog.suspend(thread_id);
+    }
+    if (watched){
+        m_watchdog.task_started(thread_id, site, submit_ns);
+    }
+    if (m_hooks.before_task){
+        m_hooks.before_task(thread_id, site);
+    }
+    function();
+    if (m_hooks.after_task){
+        m_hooks.after_task(thread_id, site);
+    }
+    if (watched){
+        m_watchdog.task_finished(thread_id);
+    }
+    if (nested){
+        m_watchdog.resume(thread_id, outer);
+    }
+
+    // Counted here rather than per job, so the tasks a relay runs count one
+    // by one and a relay that found nothing to run does not count at all
+    worker.completed.store(worker.completed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if constexpr (Stats::enabled) {
+        m_thread_info[thread_id]->add_task();
+    }
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::wake_one() {
+    uint32_t active = m_active_workers.load();
+    if (active >= get_possible_threads() && m_spare_threads == 0){
+        m_idle.notify_one();
+        return;
+    }
+    // Only the active workers and the spares standing in for blocked ones
+    // take shared tasks
+    uint32_t spares = active_spares();
+    if (active >= get_possible_threads()){
+        m_idle.notify_one_of(active + spares);
+    } else{
+        m_idle.notify_one_of(active);
+        if (spares > 0){
+            m_idle.notify(get_possible_threads() + spares - 1);
+        }
+    }
+    // If either shrank meanwhile the wake-up may have gone to a worker that no
+    // longer looks, so wake one of those that certainly still do too
+    uint32_t now_active = m_active_workers.load();
+    if (now_active < active || active_spares() < spares){
+        m_idle.notify_one_of(now_active);
+    }
+}
+
+POOLE_TEMPLATE
+uint32_t POOLE_TYPE::worker_slots() const {
+    return m_total_possible_threads + m_spare_threads;
+}
+
+POOLE_TEMPLATE
+uint32_t POOLE_TYPE::started_slots() const {
+    return m_total_possible_threads + m_started_spares.load();
+}
+
+POOLE_TEMPLATE
+uint32_t POOLE_TYPE::active_spares() const {
+    return std::min(m_blocked_workers.load(), m_spare_threads);
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::is_active(uint32_t thread_id) const {
+    if (thread_id < m_total_possible_threads){
+        return thread_id < m_active_workers.load();
+    }
+    return thread_id - m_total_possible_threads < active_spares();
+}
+
+POOLE_TEMPLATE
+BlockingRegion POOLE_TYPE::blocking_region() {
+    return BlockingRegion();
+}
+
+POOLE_TEMPLATE
+uint32_t POOLE_TYPE::get_blocked_threads() {
+    return m_blocked_workers.load();
+}
+
+POOLE_TEMPLATE
+uint32_t POOLE_TYPE::get_spare_threads() {
+    return m_spare_threads;
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::enter_blocking() {
+    uint32_t blocked = m_blocked_workers.fetch_add(1) + 1;
+    if (blocked <= m_spare_threads){
+        // The spare takes over the queue while the worker waits. It is started
+        // the first time, after that it is only woken, which costs a futex wake.
+        uint32_t spare = get_possible_threads() + blocked - 1;
+        ensure_worker(spare);
+        m_idle.notify(spare);
+    }
+
+    // Tasks already taken into the private buffer would wait for the blocked
+    // worker, hand them to its deque where any worker can steal them
+    Worker& own = *m_workers[t_current_worker];
+    while (own.batch_head < own.batch_size){
+        job_type job = std::move(own.batch[own.batch_head++]);
+        if (!push_local(job)){
+            push_shared(job);
+        }
+    }
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::leave_blocking() {
+    m_blocked_workers.fetch_sub(1);
+    // The spare that just stopped looking may have been the one woken for a
+    // queued task, pass it on
+    if (m_pending.load() > 0){
+        wake_one();
+    }
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::finish_task() {
+    //Inform the wait condition_variable once the last function has been completed
+    if (m_outstanding.fetch_sub(1) == 1) {
+        { std::lock_guard<std::mutex> wait_lock(m_wait_mutex); }
+        m_wait_execution_notifier.notify_all();
+    }
+}
+
+POOLE_TEMPLATE
+uint32_t POOLE_TYPE::resolve_threads(int32_t total_threads, bool allow_oversubscription){
+    // Set the number of threads based on a few factors:
+    // - There needs to be at least 1 thread
+    // - Any negative threads default to the CPUs the process may use, the
+    //   hardware narrowed by the affinity mask and the cgroup's CPU quota
+    // - The specified number should be between 1 - MAX_POSSIBLE_THREADS
+    int32_t possible_threads = total_threads;
+    int32_t MAX_THREADS_POSSIBLE = std::thread::hardware_concurrency();
+    if (MAX_THREADS_POSSIBLE < 1){
+        // hardware_concurrency() is allowed to return 0 when it cannot tell
+        MAX_THREADS_POSSIBLE = 1;
+    }
+    int32_t DEFAULT_THREADS = static_cast<int32_t>(CpuBudget::default_threads());
+    if (total_threads < 1){
+        // 0 and negative threads
+        possible_threads = std::min(DEFAULT_THREADS, MAX_THREADS_POSSIBLE);
+    } else{
+        // Set thread number to maximum number possible if the number specified
+        // is bigger than the total possible on the system, unless asked to
+        // oversubscribe, e.g. for tasks that mostly wait
+        if(total_threads > MAX_THREADS_POSSIBLE && !allow_oversubscription){
+            possible_threads = MAX_THREADS_POSSIBLE;
+        }
+    }
+    return static_cast<uint32_t>(possible_threads);
+}
+
+//Initialises the thread Poole
+POOLE_TEMPLATE
+void POOLE_TYPE::init(){
+    // Reserve exactly the amount of space needed for the threads
+    // The blocking spares follow the regular workers
+    m_workers.reserve(worker_slots());
+    for(uint32_t i = 0; i < worker_slots(); ++i){
+        m_workers.push_back(std::make_unique<Worker>(worker_slots()));
+        m_workers.back()->blocking.pool = this;
+    }
+    if constexpr (Stats::enabled) {
+        m_thread_info.reserve(worker_slots());
+
+        // Create the thread information before any thread can touch it
+        for(uint32_t i = 0; i < worker_slots(); ++i){
+            auto thread_info = std::make_unique<ThreadInfo>();
+            thread_info->set_ID(i);
+            thread_info->set_busy(false); // Initially not busy
+            thread_info->set_done(true); // Initially done (no task assigned)
+            m_thread_info.push_back(std::move(thread_info));
+        }
+    }
+
+    // Create the threads that will wait on functions. A lazy pool starts
+    // them as tasks arrive, so constructing it costs no thread at all, and
+    // spares only start once a worker blocks.
+    m_threads.resize(worker_slots());
+    if (m_worker_config.lazy_spawn){
+        return;
+    }
+    std::lock_guard<std::mutex> spawn_lock(m_spawn_mutex);
+    for(uint32_t i = 0; i < get_possible_threads(); ++i){
+        spawn_worker_locked(i);
+    }
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::spawn_worker_locked(uint32_t thread_id) {
+    // A retired worker may still be on its way out, its ThreadInfo and arena
+    // must be released before the new thread takes them over
+    if (m_threads[thread_id].joinable()){
+        m_threads[thread_id].join();
+    }
+    m_workers[thread_id]->alive.store(true);
+    m_live_workers.fetch_add(1);
+    if (thread_id >= m_total_possible_threads){
+        uint32_t started = thread_id - m_total_possible_threads + 1;
+        if (started > m_started_spares.load()){
+            m_started_spares.store(started);
+        }
+    }
+    m_threads[thread_id] = WorkerThread(m_worker_config, thread_id, [this, thread_id](){zombie_loop(thread_id);});
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::maybe_spawn(uint64_t backlog) {
+    if (!m_worker_config.lazy_spawn && m_worker_config.idle_timeout.count() <= 0){
+        return;
+    }
+    // Sleeping workers take the backlog once notified, only start another
+    // thread when there are more tasks than sleepers. The task was counted
+    // before this read, so a worker retiring concurrently either shows up
+    // here or sees the task in retire() and stays.
+    uint32_t live = m_live_workers.load();
+    if (live >= worker_slots() || (live > 0 && m_idle.sleepers() >= backlog)){
+        return;
+    }
+
+    // Only active workers and spares would take the backlog
+    std::lock_guard<std::mutex> spawn_lock(m_spawn_mutex);
+    if (m_stop_processing.load()){
+        return;
+    }
+    for(uint32_t i = 0; i < worker_slots(); ++i){
+        if (is_active(i) && !m_workers[i]->alive.load()){
+            spawn_worker_locked(i);
+            return;
+        }
+    }
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::ensure_worker(uint32_t thread_id) {
+    // The pinned task is counted by the caller first, so the owner either
+    // shows up alive here or sees the task in retire() and stays
+    if (m_workers[thread_id]->alive.load()){
+        return;
+    }
+    std::lock_guard<std::mutex> spawn_lock(m_spawn_mutex);
+    if (!m_workers[thread_id]->alive.load() && !m_stop_processing.load()){
+        spawn_worker_locked(thread_id);
+    }
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::retire(uint32_t thread_id) {
+    std::lock_guard<std::mutex> spawn_lock(m_spawn_mutex);
+    if (m_stop_processing.load() || m_emergency_stop.load() || m_paused.load()){
+        return false;
+    }
+    // Leave first and look for work after, the mirror image of a submitter
+    // that counts its task and then looks for workers
+    Worker& worker = *m_workers[thread_id];
+    m_live_workers.fetch_sub(1);
+    worker.alive.store(false);
+    if (has_work(thread_id)){
+        worker.alive.store(true);
+        m_live_workers.fetch_add(1);
+        return false;
+    }
+    return true;
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::exit_worker(uint32_t thread_id) {
+    if (m_hooks.on_worker_stop){
+        m_hooks.on_worker_stop(thread_id);
+    }
+    BlockingRegion::set_current(nullptr);
+    WorkerArena::set_current(nullptr);
+    t_current_pool = nullptr;
+    if constexpr (Stats::enabled) {
+        m_thread_info[thread_id]->detach_from_current_thread();
+    }
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::pause(bool pause) {
+    // Pausing needs no wake-up, running workers notice it after their task
+    // and sleeping ones stay asleep. Resuming wakes the sleepers.
+    if (!m_paused.exchange(pause) || pause){
+        return;
+    }
+    m_idle.notify_all();
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::wait() {
+    bool was_paused = false;
+    if (m_paused.exchange(false)) {
+        was_paused = true; // Temporarily unpause to allow tasks to be processed
+        m_idle.notify_all(); // Wake up workers if they were paused
+    }
+    {
+        std::unique_lock<std::mutex> wait_lock(m_wait_mutex);
+        m_wait_execution_notifier.wait(
+            wait_lock,
+            [this](){
+                return m_outstanding.load() == 0;
+            });
+    }
+    if (was_paused) {
+        m_paused = true; // Restore original paused state
+    }
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::is_done() {
+    // Every task that left the queue but has not finished yet is being executed
+    // by a thread. If there are none, all threads are done.
+    return !is_busy();
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::is_busy() {
+    // Read the queues before the total so the difference can never go negative
+    uint64_t queued = get_queued_tasks();
+    return m_outstanding.load() > queued;
+}
+
+POOLE_TEMPLATE
+uint64_t POOLE_TYPE::get_queued_tasks() const {
+    uint64_t queued = m_pending.load();
+    for (auto const& worker : m_workers){
+        queued += worker->pinned_pending.load() + worker->local_pending.load();
+    }
+    return queued;
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::is_stealable(const Worker& worker) const {
+    return worker.pinned_pending.load() > m_steal_threshold.load();
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::has_work(uint32_t thread_id) const {
+    if (m_stop_processing.load() || m_emergency_stop.load()){
+        return true;
+    }
+    if (m_paused.load()){
+        return false;
+    }
+    const Worker& own = *m_workers[thread_id];
+    if (own.batch_head < own.batch_size){
+        return true;
+    }
+    if (own.pinned_pending.load() > 0 || own.local_pending.load() > 0){
+        return true;
+    }
+    if (!is_active(thread_id)){
+        return false;
+    }
+    if (m_pending.load() > 0){
+        return true;
+    }
+    // Spares that never ran hold no tasks
+    uint32_t slots = started_slots();
+    for (uint32_t i = 0; i < slots; ++i){
+        const Worker& worker = *m_workers[i];
+        if (worker.local_pending.load() > 0 || is_stealable(worker)){
+            return true;
+        }
+    }
+    return false;
+}
+
+POOLE_TEMPLATE
+uint32_t POOLE_TYPE::batch_size() const {
+    // Take a fair share of the backlog. Idle peers count twice, they could
+    // start on it right away and should not be left without work.
+    uint64_t divisor = m_total_possible_threads + m_idle.sleepers();
+    uint64_t share = m_pending.load(std::memory_order_relaxed) / divisor;
+    return static_cast<uint32_t>(std::max<uint64_t>(1, std::min<uint64_t>(share, m_batch_limit.load())));
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::take_task(uint32_t thread_id, job_type& job) {
+    // The newest task submitted by this worker's own tasks comes first, it
+    // works on what its parent just loaded. Then the tasks already taken from
+    // the shared queue, then the own pinned tasks as their data is most likely
+    // still in this cache.
+    Worker& own = *m_workers[thread_id];
+    if (own.local_pending.load() > 0 && own.local.pop_newest(job)){
+        own.local_pending.fetch_sub(1);
+        return true;
+    }
+    if (own.batch_head < own.batch_size){
+        job = std::move(own.batch[own.batch_head++]);
+        return true;
+    }
+    if (own.pinned_pending.load() > 0 && own.pinned.try_pop(job, thread_id)){
+        own.pinned_pending.fetch_sub(1);
+        return true;
+    }
+
+    // A worker beyond the active limit only runs its own tasks, unless the
+    // pool is draining its queues to stop
+    if (!is_active(thread_id) && !m_stop_processing.load()){
+        return false;
+    }
+
+    // Take a batch from the shared queue with a single acquisition, the first
+    // task runs now and the rest wait in the private buffer
+    uint32_t wanted = batch_size();
+    if (wanted == 1){
+        if (m_function_queue.try_pop(job, thread_id)){
+            m_pending.fetch_sub(1);
+            return true;
+        }
+    } else{
+        auto taken = static_cast<uint32_t>(
+                m_function_queue.try_pop_batch(own.batch.get(), wanted, thread_id));
+        if (taken > 0){
+            m_pending.fetch_sub(taken);
+            job = std::move(own.batch[0]);
+            own.batch_head = 1;
+            own.batch_size = taken;
+            return true;
+        }
+    }
+
+    // Steal the oldest locally submitted task of any worker, and pinned tasks
+    // only from workers that have more waiting than they can handle
+    uint32_t slots = started_slots();
+    for (uint32_t i = 1; i < slots; ++i){
+        Worker& victim = *m_workers[(thread_id + i) % slots];
+        if (victim.local_pending.load() > 0 && victim.local.steal_oldest(job)){
+            victim.local_pending.fetch_sub(1);
+            m_stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (is_stealable(victim) && victim.pinned.try_pop(job, thread_id)){
+            victim.pinned_pending.fetch_sub(1);
+            m_stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::zombie_loop(uint32_t thread_id) {
+    // This function is an infinite loop used to obtain functions from the list
+    // to execute
+    if constexpr (Stats::enabled) {
+        m_thread_info[thread_id]->attach_to_current_thread();
+    }
+    WorkerArena::set_current(&m_workers[thread_id]->arena);
+    BlockingRegion::set_current(&m_workers[thread_id]->blocking);
+    t_current_pool = this;
+    t_current_worker = thread_id;
+    if (m_hooks.on_worker_start){
+        m_hooks.on_worker_start(thread_id);
+    }
+    job_type job;
+    while (true){
+        // A stopping pool drains its queue even when it is paused
+        bool may_take = !m_paused.load() || m_stop_processing.load();
+        if (may_take && take_task(thread_id, job)){
+            release_space();
+            execute(thread_id, job);
+            continue;
+        }
+
+        // Stop the function when there are no more tasks and asked to stop,
+        // or if requested to stop via the emergency stop procedure
+        const Worker& own = *m_workers[thread_id];
+        bool drained = m_pending.load() == 0 && own.pinned_pending.load() == 0
+                && own.local_pending.load() == 0 && own.batch_head == own.batch_size;
+        if((m_stop_processing && drained) || m_emergency_stop){
+            exit_worker(thread_id);
+            return;
+        }
+
+        // Wait for available tasks, and give the thread back once nothing
+        // came for the idle timeout
+        if constexpr (Stats::enabled) {
+            m_thread_info[thread_id]->set_state(ThreadInfo::State::Parked);
+        }
+        bool timed_out = false;
+        if (m_worker_config.idle_timeout.count() > 0){
+            timed_out = !m_idle.park_for(thread_id, [this, thread_id](){ return has_work(thread_id); },
+                    m_worker_config.idle_timeout);
+        } else{
+            m_idle.park(thread_id, [this, thread_id](){ return has_work(thread_id); });
+        }
+        if constexpr (Stats::enabled) {
+            m_thread_info[thread_id]->set_state(ThreadInfo::State::Idle);
+        }
+        if (timed_out && retire(thread_id)){
+            exit_worker(thread_id);
+            return;
+        }
+    }
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::execute(uint32_t thread_id, job_type& job) {
+    // Update statistics for the thread, a nested task is part of the busy
+    // time of the one running it
+    Worker& worker = *m_workers[thread_id];
+    if constexpr (Stats::enabled) {
+        if (worker.depth == 0){
+            m_thread_info[thread_id]->set_state(ThreadInfo::State::Busy);
+        }
+    }
+
+    // Execute the task and release whatever it captured straight away. Only
+    // this worker writes its counters, so plain stores are enough.
+    worker.depth++;
+    worker.running.store(1, std::memory_order_relaxed);
+    if (job.site.relay){
+        // The tasks it runs report and count themselves
+        job.task();
+    } else{
+        run_as(job.site, job.submit_ns, job.task);
+    }
+    job.task = Task();
+    // The task and whatever it captured are gone, so is all it allocated,
+    // unless it ran nested in a task that still uses the arena
+    bool outermost = --worker.depth == 0;
+    if (outermost){
+        worker.arena.reset();
+        worker.running.store(0, std::memory_order_relaxed);
+    }
+
+    // Update job statistics for the thread
+    if constexpr (Stats::enabled) {
+        if (outermost){
+            m_thread_info[thread_id]->set_state(ThreadInfo::State::Idle);
+        }
+    }
+
+    finish_task();
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::force_stop() {
+    {
+        // No worker retires once the pool stops. Those that already did are
+        // started again if tasks still wait for them, so the queues drain.
+        std::lock_guard<std::mutex> spawn_lock(m_spawn_mutex);
+        stop_processing(true);
+        for(uint32_t i = 0; i < get_possible_threads(); ++i){
+            if (!m_workers[i]->alive.load() && m_workers[i]->pinned_pending.load() > 0){
+                spawn_worker_locked(i);
+            }
+        }
+        if (m_live_workers.load() == 0 && m_pending.load() > 0){
+            spawn_worker_locked(0);
+        }
+    }
+
+    // Wake up all threads to let them exit their loops
+    m_idle.notify_all();
+
+    // Join the threads for to finish execution
+    for (auto& thread : m_threads){
+        if(thread.joinable()){
+            thread.join();
+        }
+    }
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::stop_processing(bool con) {
+    m_stop_processing = con;
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::set_possible_threads(uint32_t possible_threads) {
+    m_total_possible_threads = possible_threads;
+}
+
+
+// Returns the number of threads possible on the current hardware.
+POOLE_TEMPLATE
+uint32_t POOLE_TYPE::get_possible_threads() {
+    return m_total_possible_threads;
+}
+
+POOLE_TEMPLATE
+uint32_t POOLE_TYPE::get_live_threads() {
+    return m_live_workers.load();
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::set_active_threads(uint32_t threads) {
+    threads = std::max(1u, std::min(threads, get_possible_threads()));
+    uint32_t before = m_active_workers.exchange(threads);
+    if (threads > before){
+        // Newly active workers may find shared tasks waiting, a lazy pool may
+        // have to start them first
+        m_idle.notify_all();
+        maybe_spawn(m_pending.load());
+    }
+}
+
+POOLE_TEMPLATE
+uint32_t POOLE_TYPE::get_active_threads() {
+    return m_active_workers.load();
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::watch_cpu_throttling(std::chrono::milliseconds interval, CpuBudget budget) {
+    stop_watching_cpu_throttling();
+    if (!budget.throttle()){
+        return false;
+    }
+    // The watch only ever works below what the user set. The flag is written
+    // by its thread, which has ended by the time it is read.
+    m_throttle_restore = get_active_threads();
+    m_throttle_applied = false;
+    m_throttle_watch = std::make_unique<ThrottleWatch>(std::move(budget), m_throttle_restore, interval,
+            [this](uint32_t threads){
+                m_throttle_applied = true;
+                set_active_threads(threads);
+            });
+    return true;
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::stop_watching_cpu_throttling() {
+    if (!m_throttle_watch){
+        return;
+    }
+    m_throttle_watch.reset();
+    if (m_throttle_applied){
+        set_active_threads(m_throttle_restore);
+    }
+}
+
+POOLE_TEMPLATE
+std::vector<unsigned long long> POOLE_TYPE::get_thread_total_tasks_executed() {
+    std::vector<unsigned long long> to_return(started_slots(), 0);
+
+    if constexpr (Stats::enabled) {
+        for(size_t i = 0; i < to_return.size(); ++i){
+            to_return[i] = m_thread_info[i]->get_tasks();
+        }
+    }
+
+    return to_return;
+}
+
+POOLE_TEMPLATE
+std::vector<unsigned long long> POOLE_TYPE::get_thread_total_uptime() {
+    std::vector<unsigned long long> to_return(started_slots(), 0);
+
+    if constexpr (Stats::enabled) {
+        for(size_t i = 0; i < to_return.size(); ++i){
+            to_return[i] = m_thread_info[i]->get_uptime();
+        }
+    }
+
+    return to_return;
+}
+
+POOLE_TEMPLATE
+uint64_t POOLE_TYPE::get_total_tasks_executed() {
+    uint64_t to_return = 0;
+
+    // Sum all the tasks executed
+    for (auto count : get_thread_total_tasks_executed()){
+        to_return += count;
+    }
+
+    return to_return;
+}
+
+POOLE_TEMPLATE
+uint64_t POOLE_TYPE::get_total_uptime() {
+    uint64_t to_return = 0;
+
+    // Scan for the thread with the longest running time and use that
+    for(auto uptime : get_thread_total_uptime()){
+        if(uptime >= to_return){
+            to_return = uptime;
+        }
+    }
+
+    return to_return;
+}
+
+POOLE_TEMPLATE
+std::vector<double> POOLE_TYPE::get_thread_utilization() {
+    std::vector<double> to_return(started_slots(), 0.0);
+
+    if constexpr (Stats::enabled) {
+        for(size_t i = 0; i < to_return.size(); ++i){
+            to_return[i] = m_thread_info[i]->get_utilization();
+        }
+    }
+
+    return to_return;
+}
+
+POOLE_TEMPLATE
+std::vector<uint64_t> POOLE_TYPE::get_thread_cpu_time() {
+    std::vector<uint64_t> to_return(started_slots(), 0);
+
+    if constexpr (Stats::enabled) {
+        for(size_t i = 0; i < to_return.size(); ++i){
+            to_return[i] = m_thread_info[i]->get_cpu_time();
+        }
+    }
+
+    return to_return;
+}
+
+POOLE_TEMPLATE
+double POOLE_TYPE::get_total_utilization() {
+    uint64_t busy = 0;
+    uint64_t total = 0;
+
+    if constexpr (Stats::enabled) {
+        for(uint32_t i = 0; i < started_slots(); ++i){
+            const auto& thread_info = m_thread_info[i];
+            uint64_t thread_busy = thread_info->get_busy_time();
+            busy += thread_busy;
+            total += thread_busy + thread_info->get_idle_time() + thread_info->get_parked_time();
+        }
+    }
+
+    return total == 0 ? 0.0 : static_cast<double>(busy) / static_cast<double>(total);
+}
+
+POOLE_TEMPLATE
+uint64_t POOLE_TYPE::get_pending_tasks() {
+    // Everything submitted that has not started, including batched tasks
+    uint64_t outstanding = m_outstanding.load();
+    uint64_t running = get_running_tasks();
+    return outstanding > running ? outstanding - running : 0;
+}
+
+POOLE_TEMPLATE
+uint64_t POOLE_TYPE::get_running_tasks() {
+    uint64_t running = 0;
+    for (const auto& worker : m_workers){
+        running += worker->running.load(std::memory_order_relaxed);
+    }
+    return running;
+}
+
+POOLE_TEMPLATE
+uint64_t POOLE_TYPE::get_peak_pending_tasks() {
+    return m_peak_pending.load(std::memory_order_relaxed);
+}
+
+POOLE_TEMPLATE
+uint64_t POOLE_TYPE::reset_peak_pending_tasks() {
+    return m_peak_pending.exchange(0, std::memory_order_relaxed);
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::start_sampling(std::chrono::milliseconds period, std::size_t window) {
+    stop_sampling();
+    m_sampler = std::make_unique<PooleSampler>(period, window, [this](){
+        PooleSampler::Counters counters;
+        counters.completed = get_completed_tasks();
+        counters.running = get_running_tasks();
+        counters.pending = get_pending_tasks();
+        return counters;
+    });
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::stop_sampling() {
+    m_sampler.reset();
+}
+
+POOLE_TEMPLATE
+std::vector<PooleSample> POOLE_TYPE::get_samples() {
+    if (!m_sampler){
+        return {};
+    }
+    return m_sampler->samples();
+}
+
+POOLE_TEMPLATE
+uint64_t POOLE_TYPE::get_completed_tasks() const {
+    uint64_t completed = 0;
+    for (const auto& worker : m_workers){
+        completed += worker->completed.load(std::memory_order_relaxed);
+    }
+    return completed;
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::update_peak_pending(uint64_t depth) {
+    // Only a new peak writes, so the common case is a single shared read
+    uint64_t peak = m_peak_pending.load(std::memory_order_relaxed);
+    while (depth > peak && !m_peak_pending.compare_exchange_weak(peak, depth, std::memory_order_relaxed)){
+    }
+}
+
+POOLE_TEMPLATE
+uint64_t POOLE_TYPE::get_total_tasks_stolen() {
+    return m_stolen.load(std::memory_order_relaxed);
+}
+
+POOLE_TEMPLATE
+uint64_t POOLE_TYPE::get_total_task_allocations() {
+    return m_task_allocations.load(std::memory_order_relaxed);
+}
+
+POOLE_TEMPLATE
+uint64_t POOLE_TYPE::get_total_task_allocated_bytes() {
+    return m_task_allocated_bytes.load(std::memory_order_relaxed);
+}
+
+POOLE_TEMPLATE
+uint64_t POOLE_TYPE::get_total_spurious_wakeups() {
+    return m_idle.spurious_wakeups();
+}
+
+POOLE_TEMPLATE
+std::string POOLE_TYPE::statistics() {
+    if constexpr (!Stats::enabled) {
+        return "Statistics are disabled (StatsPolicy::None)\n";
+    } else{
+        std::string to_return = "";
+        PooleStats stats = snapshot();
+
+        // Add the information for each individual thread
+        for (const auto& worker: stats.workers){
+            to_return += "Thread ";
+
+            if (worker.id < 10){
+                to_return += "00";
+            }else if (worker.id < 100) {
+                to_return += "0";
+            }
+            to_return += std::to_string(worker.id);
+            to_return += " " + std::to_string(worker.tasks) + " tasks,";
+            to_return += " " + std::to_string(worker.uptime_ms) + " ms,";
+            to_return += " " + std::to_string(static_cast<int>(worker.utilization * 100.0)) + "% busy,";
+            to_return += " " + std::to_string(worker.cpu_ns / 1000000) + " ms cpu";
+            to_return += "\n";
+        }
+
+        // Add the summary information for all threads
+        to_return += "\n";
+        to_return += "Total Tasks:  " + std::to_string(stats.tasks_executed) + "\n";
+        to_return += "Total Uptime: " + std::to_string(stats.uptime_ms)+ " ms \n";
+        to_return += "Utilization:  " + std::to_string(static_cast<int>(stats.utilization * 100.0)) + "% busy\n";
+        to_return += "Spurious Wake-ups: " + std::to_string(stats.spurious_wakeups) + "\n";
+
+        // Task storage per task executed, the closures that did not fit inline
+        uint64_t tasks = std::max<uint64_t>(stats.tasks_executed, 1);
+        char storage[96];
+        std::snprintf(storage, sizeof(storage), "Task Storage: %.2f allocations, %.1f bytes per task\n",
+                static_cast<double>(stats.task_allocations) / tasks,
+                static_cast<double>(stats.task_allocated_bytes) / tasks);
+        to_return += storage;
+
+        return to_return;
+    }
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::snapshot(PooleStats& stats) {
+    // Spares that never started are left out
+    stats.threads = started_slots();
+    stats.tasks_stolen = m_stolen.load(std::memory_order_relaxed);
+    stats.spurious_wakeups = m_idle.spurious_wakeups();
+    stats.pending = get_pending_tasks();
+    stats.running = get_running_tasks();
+    stats.outstanding = m_outstanding.load();
+    stats.peak_pending = get_peak_pending_tasks();
+    stats.task_allocations = get_total_task_allocations();
+    stats.task_allocated_bytes = get_total_task_allocated_bytes();
+    stats.tasks_executed = 0;
+    stats.uptime_ms = 0;
+    stats.utilization = 0.0;
+    std::fill(std::begin(stats.task_time_buckets), std::end(stats.task_time_buckets), 0);
+    stats.workers.clear();
+
+    if constexpr (Stats::enabled) {
+        // Totals are summed from the per-worker snapshots so they agree
+        uint64_t busy = 0;
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < stats.threads; ++i){
+            const auto& thread_info = m_thread_info[i];
+            stats.workers.push_back(thread_info->snapshot());
+            thread_info->add_task_times(stats.task_time_buckets);
+            const ThreadSnapshot& worker = stats.workers.back();
+            stats.tasks_executed += worker.tasks;
+            stats.uptime_ms = std::max(stats.uptime_ms, worker.uptime_ms);
+            busy += worker.busy_ns;
+            total += worker.busy_ns + worker.idle_ns + worker.parked_ns;
+        }
+        if (total > 0){
+            stats.utilization = static_cast<double>(busy) / static_cast<double>(total);
+        }
+    }
+}
+
+POOLE_TEMPLATE
+bool POOLE_TYPE::publish_stats(const std::string& path, std::chrono::milliseconds interval) {
+    stop_publishing_stats();
+    m_stats_publisher = std::make_unique<StatsSegment::Publisher>(path, interval,
+            [this](PooleStats& stats){ snapshot(stats); });
+    if (!m_stats_publisher->is_open()){
+        m_stats_publisher.reset();
+        return false;
+    }
+    return true;
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::stop_publishing_stats() {
+    m_stats_publisher.reset();
+}
+
+POOLE_TEMPLATE
+PooleStats POOLE_TYPE::snapshot() {
+    PooleStats stats;
+    snapshot(stats);
+    return stats;
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::enable_watchdog(const WatchdogConfig& config) {
+    m_watchdog.enable(config);
+}
+
+POOLE_TEMPLATE
+void POOLE_TYPE::disable_watchdog() {
+    m_watchdog.disable();
+}
+
+POOLE_TEMPLATE
+std::vector<CallsiteReport> POOLE_TYPE::get_watchdog_report() {
+    return m_watchdog.report();
+}
+
+#undef POOLE_TEMPLATE
+#undef POOLE_TYPE
@@ -0,0 +1,673 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains the policies that BasicPoole is built from. A policy
+ *          decides one aspect of the pool at compile time:
+ *          - QueuePolicy: where submitted tasks are stored until a worker
+ *            takes them. Queues are internally synchronised. Every policy
+ *            provides a shared queue (type) and a per-worker queue
+ *            (local_type) used for tasks pinned to one worker.
+ *          - IdlePolicy: how a worker waits when there is nothing to do, and
+ *            how a submitter wakes it up again.
+ *          - StatsPolicy: whether per-thread statistics are kept at all.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Tells the CPU that the caller is busy-waiting, which frees resources
+ *          for the sibling hyper-thread and saves power
+ */
+inline void poole_cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#else
+  std::this_thread::yield();
+#endif
+}
+
+namespace QueuePolicy {
+
+/**
+ * @brief A single first-in first-out queue guarded by one mutex. This is the
+ *          queue Poole has always used.
+ */
+struct Fifo {
+  template <typename Task>
+  class type {
+   public:
+    explicit type(uint32_t /*total_workers*/) {}
+
+    /**
+     * @brief Adds a task to the back of the queue
+     *
+     * @return true once the task is stored, a Fifo queue never fills up
+     */
+    bool push(Task&& task) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_queue.push(std::move(task));
+      return true;
+    }
+
+    /**
+     * @brief Takes the task at the front of the queue
+     *
+     * @param task receives the task when one is available
+     * @return true if a task was taken, false if the queue was empty
+     */
+    bool try_pop(Task& task, uint32_t /*worker_id*/) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_queue.empty()) {
+        return false;
+      }
+      task = std::move(m_queue.front());
+      m_queue.pop();
+      return true;
+    }
+
+    /**
+     * @brief Takes up to max_tasks tasks from the front of the queue at once
+     *
+     * @param tasks receives the tasks, it must have room for max_tasks
+     * @return std::size_t the number of tasks taken
+     */
+    std::size_t try_pop_batch(Task* tasks, std::size_t max_tasks, uint32_t /*worker_id*/) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::size_t taken = 0;
+      while (taken < max_tasks && !m_queue.empty()) {
+        tasks[taken++] = std::move(m_queue.front());
+        m_queue.pop();
+      }
+      return taken;
+    }
+
+   private:
+    std::mutex m_mutex;
+    std::queue<Task> m_queue;
+  };
+
+  template <typename Task>
+  using local_type = type<Task>;
+};
+
+/**
+ * @brief A fixed-capacity ring buffer whose slots are allocated once when the
+ *          pool is constructed. Pushing and popping never touch the heap, and
+ *          a push onto a full queue fails instead of growing it.
+ *
+ * @tparam Capacity the number of tasks that can be pending at once
+ */
+template <std::size_t Capacity>
+struct Bounded {
+  static_assert(Capacity > 0, "A Bounded queue needs at least one slot");
+
+  template <typename Task>
+  class type {
+   public:
+    explicit type(uint32_t /*total_workers*/) : m_slots(Capacity) {}
+
+    /**
+     * @brief Adds a task to the back of the ring
+     *
+     * @return true if the task was stored, false if the ring is full, in which
+     *          case the task is left untouched
+     */
+    bool push(Task&& task) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_size == Capacity) {
+        return false;
+      }
+      m_slots[(m_head + m_size) % Capacity] = std::move(task);
+      ++m_size;
+      return true;
+    }
+
+    /**
+     * @brief Takes the task at the front of the ring
+     */
+    bool try_pop(Task& task, uint32_t /*worker_id*/) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_size == 0) {
+        return false;
+      }
+      task = std::move(m_slots[m_head]);
+      m_head = (m_head + 1) % Capacity;
+      --m_size;
+      return true;
+    }
+
+    /**
+     * @brief Takes up to max_tasks tasks from the front of the ring at once
+     */
+    std::size_t try_pop_batch(Task* tasks, std::size_t max_tasks, uint32_t /*worker_id*/) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::size_t taken = 0;
+      while (taken < max_tasks && m_size > 0) {
+        tasks[taken++] = std::move(m_slots[m_head]);
+        m_head = (m_head + 1) % Capacity;
+        --m_size;
+      }
+      return taken;
+    }
+
+   private:
+    std::mutex m_mutex;
+    std::vector<Task> m_slots;
+    std::size_t m_head = 0;
+    std::size_t m_size = 0;
+  };
+
+  // Every worker gets its own ring of the same capacity
+  template <typename Task>
+  using local_type = type<Task>;
+};
+
+/**
+ * @brief The shared queue is split into shards, each with its own lock, so
+ *          producers no longer contend on a single mutex. A producer picks two
+ *          shards at random and pushes onto the shorter one, and a worker scans
+ *          its home shard first before looking at the others. Tasks within a
+ *          shard stay in FIFO order.
+ *
+ * @tparam Shards the number of shards, 0 gives every worker a home shard
+ */
+template <std::size_t Shards = 0>
+struct Sharded {
+  template <typename Task>
+  class type {
+   public:
+    explicit type(uint32_t total_workers)
+        : m_shard_count(Shards > 0 ? Shards : std::max<uint32_t>(total_workers, 1)),
+          m_shards(new Shard[m_shard_count]) {}
+
+    /**
+     * @brief Adds a task to the shorter of two randomly chosen shards
+     *
+     * @return true once the task is stored, shards never fill up
+     */
+    bool push(Task&& task) {
+      Shard& shard = choose_shard();
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.queue.push(std::move(task));
+      shard.size.fetch_add(1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * @brief Takes a task, starting from the home shard of the worker
+     */
+    bool try_pop(Task& task, uint32_t worker_id) {
+      return try_pop_batch(&task, 1, worker_id) == 1;
+    }
+
+    /**
+     * @brief Takes up to max_tasks tasks from the first shard that has any,
+     *          starting from the home shard of the worker
+     */
+    std::size_t try_pop_batch(Task* tasks, std::size_t max_tasks, uint32_t worker_id) {
+      for (std::size_t i = 0; i < m_shard_count; ++i) {
+        Shard& shard = m_shards[(worker_id + i) % m_shard_count];
+        // Skip empty shards without taking their lock
+        if (shard.size.load(std::memory_order_acquire) == 0) {
+          continue;
+        }
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        std::size_t taken = 0;
+        while (taken < max_tasks && !shard.queue.empty()) {
+          tasks[taken++] = std::move(shard.queue.front());
+          shard.queue.pop();
+        }
+        if (taken > 0) {
+          shard.size.fetch_sub(taken, std::memory_order_relaxed);
+          return taken;
+        }
+      }
+      return 0;
+    }
+
+   private:
+    struct alignas(64) Shard {
+      std::mutex mutex;
+      std::queue<Task> queue;
+      std::atomic<std::size_t> size{0};
+    };
+
+    // Power of two choices: the shorter of two random shards keeps the shards
+    // balanced almost as well as a full scan, at the cost of two loads
+    Shard& choose_shard() {
+      // xorshift, seeded differently on every thread
+      thread_local uint32_t state =
+          static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1u;
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      Shard& first = m_shards[state % m_shard_count];
+      Shard& second = m_shards[(state >> 16) % m_shard_count];
+      return second.size.load(std::memory_order_relaxed) < first.size.load(std::memory_order_relaxed)
+          ? second
+          : first;
+    }
+
+    std::size_t m_shard_count;
+    std::unique_ptr<Shard[]> m_shards;
+  };
+
+  // Pinned tasks already have a single consumer, they do not need shards
+  template <typename Task>
+  using local_type = typename Fifo::template type<Task>;
+};
+
+}  // namespace QueuePolicy
+
+namespace IdlePolicy {
+
+/**
+ * @brief Idle workers sleep on one shared condition_variable. Submitters only
+ *          touch the mutex when at least one worker is actually asleep.
+ */
+class CondVar {
+ public:
+  explicit CondVar(uint32_t /*total_workers*/) {}
+
+  /**
+   * @brief Blocks the calling worker until ready() returns true
+   *
+   * @param worker_id the worker that is going to sleep
+   * @param ready the wake-up condition, it must only read seq_cst atomics
+   */
+  template <typename Ready>
+  void park(uint32_t /*worker_id*/, Ready ready) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    // Announce the sleeper before checking the condition. A submitter
+    // publishes its work before reading m_sleepers, so one of the two is
+    // guaranteed to see the other.
+    m_sleepers.fetch_add(1);
+    if (!ready()) {
+      for (;;) {
+        m_notifier.wait(lock);
+        if (ready()) {
+          break;
+        }
+        m_spurious.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    m_sleepers.fetch_sub(1);
+  }
+
+  /**
+   * @brief Blocks the calling worker until ready() returns true or the
+   *          timeout has passed
+   *
+   * @return true if ready() returned true, false on a timeout
+   */
+  template <typename Ready>
+  bool park_for(uint32_t /*worker_id*/, Ready ready, std::chrono::nanoseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_sleepers.fetch_add(1);
+    bool woken = ready();
+    while (!woken) {
+      if (m_notifier.wait_until(lock, deadline) == std::cv_status::timeout) {
+        woken = ready();
+        break;
+      }
+      woken = ready();
+      if (!woken) {
+        m_spurious.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    m_sleepers.fetch_sub(1);
+    return woken;
+  }
+
+  /**
+   * @brief Wakes one sleeping worker, if there is one
+   */
+  void notify_one() {
+    if (m_sleepers.load() > 0) {
+      // Passing through the mutex ensures the sleeper is either waiting or
+      // has not yet checked its condition
+      { std::lock_guard<std::mutex> lock(m_mutex); }
+      m_notifier.notify_one();
+    }
+  }
+
+  /**
+   * @brief Wakes one sleeping worker among workers 0..workers-1. A shared
+   *          condition_variable cannot pick one, so every sleeper is woken
+   *          and the others go back to sleep.
+   */
+  void notify_one_of(uint32_t /*workers*/) {
+    if (m_sleepers.load() > 0) {
+      { std::lock_guard<std::mutex> lock(m_mutex); }
+      m_notifier.notify_all();
+    }
+  }
+
+  /**
+   * @brief Wakes a specific worker. A shared condition_variable cannot pick
+   *          one, so every sleeper is woken and the others go back to sleep.
+   */
+  void notify(uint32_t /*worker_id*/) {
+    if (m_sleepers.load() > 0) {
+      { std::lock_guard<std::mutex> lock(m_mutex); }
+      m_notifier.notify_all();
+    }
+  }
+
+  /**
+   * @brief Wakes every sleeping worker, used for pause, resume and stop
+   */
+  void notify_all() {
+    { std::lock_guard<std::mutex> lock(m_mutex); }
+    m_notifier.notify_all();
+  }
+
+  /**
+   * @brief Get the number of workers that are currently asleep
+   */
+  uint32_t sleepers() const {
+    return m_sleepers.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the number of times a worker woke up and found nothing to do
+   */
+  uint64_t spurious_wakeups() const {
+    return m_spurious.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::mutex m_mutex;
+  std::condition_variable m_notifier;
+  std::atomic<uint32_t> m_sleepers{0};
+  std::atomic<uint64_t> m_spurious{0};
+};
+
+/**
+ * @brief Idle workers spin for a while before falling back to the
+ *          condition_variable. This trades CPU time for wake-up latency, which
+ *          pays off when tasks arrive in quick succession.
+ *
+ * @tparam Spins the number of times the condition is polled before sleeping
+ */
+template <uint32_t Spins = 4096>
+class Spin : public CondVar {
+ public:
+  explicit Spin(uint32_t total_workers) : CondVar(total_workers) {}
+
+  template <typename Ready>
+  void park(uint32_t worker_id, Ready ready) {
+    for (uint32_t i = 0; i < Spins; ++i) {
+      if (ready()) {
+        return;
+      }
+      poole_cpu_relax();
+    }
+    CondVar::park(worker_id, ready);
+  }
+
+  template <typename Ready>
+  bool park_for(uint32_t worker_id, Ready ready, std::chrono::nanoseconds timeout) {
+    for (uint32_t i = 0; i < Spins; ++i) {
+      if (ready()) {
+        return true;
+      }
+      poole_cpu_relax();
+    }
+    return CondVar::park_for(worker_id, ready, timeout);
+  }
+};
+
+/**
+ * @brief Every worker parks on its own slot, an eventcount on a futex word, so
+ *          a submitter wakes exactly one specific worker. Notifying a worker that
+ *          is awake or still spinning costs a single atomic exchange and no
+ *          system call. Platforms without futexes fall back to a mutex and a
+ *          condition_variable per slot.
+ */
+class Futex {
+ public:
+  explicit Futex(uint32_t total_workers)
+      : m_slot_count(std::max<uint32_t>(total_workers, 1)), m_slots(new Slot[m_slot_count]) {}
+
+  /**
+   * @brief Blocks the calling worker until ready() returns true
+   *
+   * @param worker_id the worker that is going to sleep, it owns that slot
+   * @param ready the wake-up condition, it must only read seq_cst atomics
+   */
+  template <typename Ready>
+  void park(uint32_t worker_id, Ready ready) {
+    Slot& slot = m_slots[worker_id % m_slot_count];
+    for (;;) {
+      // Read the epoch and announce the sleeper before checking the
+      // condition. A notifier that misses the condition bumps the epoch, and
+      // the wait below returns at once if it already moved.
+      uint32_t key = slot.epoch.load();
+      slot.waiting.store(true);
+      m_sleepers.fetch_add(1);
+      if (ready()) {
+        slot.waiting.store(false);
+        m_sleepers.fetch_sub(1);
+        return;
+      }
+      slot.wait(key);
+      slot.waiting.store(false);
+      m_sleepers.fetch_sub(1);
+
+      if (ready()) {
+        return;
+      }
+      m_spurious.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Blocks the calling worker until ready() returns true or the
+   *          timeout has passed
+   *
+   * @return true if ready() returned true, false on a timeout
+   */
+  template <typename Ready>
+  bool park_for(uint32_t worker_id, Ready ready, std::chrono::nanoseconds timeout) {
+    Slot& slot = m_slots[worker_id % m_slot_count];
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+      uint32_t key = slot.epoch.load();
+      slot.waiting.store(true);
+      m_sleepers.fetch_add(1);
+      if (ready()) {
+        slot.waiting.store(false);
+        m_sleepers.fetch_sub(1);
+        return true;
+      }
+      auto remaining = deadline - std::chrono::steady_clock::now();
+      if (remaining > std::chrono::nanoseconds(0)) {
+        slot.wait_for(key, std::chrono::duration_cast<std::chrono::nanoseconds>(remaining));
+      }
+      slot.waiting.store(false);
+      m_sleepers.fetch_sub(1);
+
+      if (ready()) {
+        return true;
+      }
+      if (std::chrono::steady_clock::now() >= deadline) {
+        return false;
+      }
+      m_spurious.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Wakes one sleeping worker, if there is one
+   */
+  void notify_one() {
+    if (m_sleepers.load() == 0) {
+      return;
+    }
+    // Start the search where the last one ended so wake-ups are spread out
+    uint32_t start = m_cursor.fetch_add(1, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < m_slot_count; ++i) {
+      if (wake(m_slots[(start + i) % m_slot_count])) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief Wakes one sleeping worker among workers 0..workers-1
+   */
+  void notify_one_of(uint32_t workers) {
+    if (m_sleepers.load() == 0) {
+      return;
+    }
+    uint32_t count = std::max<uint32_t>(1, std::min(workers, m_slot_count));
+    uint32_t start = m_cursor.fetch_add(1, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < count; ++i) {
+      if (wake(m_slots[(start + i) % count])) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief Wakes a specific worker, nothing happens if it is awake
+   */
+  void notify(uint32_t worker_id) {
+    wake(m_slots[worker_id % m_slot_count]);
+  }
+
+  /**
+   * @brief Wakes every sleeping worker, used for resume and stop
+   */
+  void notify_all() {
+    for (uint32_t i = 0; i < m_slot_count; ++i) {
+      wake(m_slots[i]);
+    }
+  }
+
+  /**
+   * @brief Get the number of workers that are currently asleep
+   */
+  uint32_t sleepers() const {
+    return m_sleepers.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the number of times a worker woke up and found nothing to do
+   */
+  uint64_t spurious_wakeups() const {
+    return m_spurious.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<uint32_t> epoch{0};
+    std::atomic<bool> waiting{false};
+#if defined(__linux__)
+    void wait(uint32_t key) {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+    }
+    void wait_for(uint32_t key, std::chrono::nanoseconds timeout) {
+      timespec relative{};
+      relative.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+      relative.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAIT_PRIVATE, key, &relative, nullptr, 0);
+    }
+    void wake() {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+#else
+    void wait(uint32_t key) {
+      std::unique_lock<std::mutex> lock(mutex);
+      notifier.wait(lock, [this, key]() { return epoch.load() != key; });
+    }
+    void wait_for(uint32_t key, std::chrono::nanoseconds timeout) {
+      std::unique_lock<std::mutex> lock(mutex);
+      notifier.wait_for(lock, timeout, [this, key]() { return epoch.load() != key; });
+    }
+    void wake() {
+      { std::lock_guard<std::mutex> lock(mutex); }
+      notifier.notify_one();
+    }
+
+    std::mutex mutex;
+    std::condition_variable notifier;
+#endif
+  };
+
+  // Only the notifier that clears the waiting flag pays for the system call
+  static bool wake(Slot& slot) {
+    if (!slot.waiting.load() || !slot.waiting.exchange(false)) {
+      return false;
+    }
+    slot.epoch.fetch_add(1);
+    slot.wake();
+    return true;
+  }
+
+  uint32_t m_slot_count;
+  std::unique_ptr<Slot[]> m_slots;
+  std::atomic<uint32_t> m_sleepers{0};
+  std::atomic<uint32_t> m_cursor{0};
+  std::atomic<uint64_t> m_spurious{0};
+};
+
+}  // namespace IdlePolicy
+
+namespace StatsPolicy {
+
+/**
+ * @brief Keep a ThreadInfo per worker and update it around every task
+ */
+struct Full {
+  static constexpr bool enabled = true;
+};
+
+/**
+ * @brief Keep no statistics, the ThreadInfo updates are compiled out
+ */
+struct None {
+  static constexpr bool enabled = false;
+};
+
+}  // namespace StatsPolicy
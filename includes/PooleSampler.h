@@ -0,0 +1,102 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains PooleSampler, which records the throughput and the
+ *          backlog of a pool at a fixed period into a ring buffer, so the last
+ *          N periods can be read at any time, e.g. to scale producers up or
+ *          down. The sampling runs on its own thread and only reads counters
+ *          the pool keeps anyway.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct PooleSample {
+  // Milliseconds since the sampler started
+  uint64_t time_ms = 0;
+  // Tasks finished per second over the period
+  double tasks_per_second = 0.0;
+  // Tasks submitted but not started, and tasks running, at the sample time
+  uint64_t pending = 0;
+  uint64_t running = 0;
+  // The expected time a task waits before it starts, estimated as the
+  // backlog divided by the throughput (Little's law). It is infinite when
+  // tasks are waiting but none finished during the period.
+  double wait_ms = 0.0;
+};
+
+class PooleSampler {
+ public:
+  // The counters read from the pool at every sample
+  struct Counters {
+    uint64_t completed = 0;
+    uint64_t pending = 0;
+    uint64_t running = 0;
+  };
+  using Source = std::function<Counters()>;
+
+  /**
+   * @brief Starts sampling straight away
+   *
+   * @param period the time between two samples
+   * @param window the number of samples kept, older ones are overwritten
+   * @param source reads the counters of the pool
+   */
+  PooleSampler(std::chrono::milliseconds period, std::size_t window, Source source);
+  ~PooleSampler();
+  PooleSampler(const PooleSampler&) = delete;
+  PooleSampler& operator=(const PooleSampler&) = delete;
+
+  /**
+   * @brief Copies the samples in the window, oldest first, into samples.
+   *          Reusing the same vector avoids allocating.
+   */
+  void samples(std::vector<PooleSample>& samples) const;
+
+  /**
+   * @brief Get the samples in the window, oldest first
+   */
+  std::vector<PooleSample> samples() const;
+
+ private:
+  void run();
+  void record(std::chrono::steady_clock::time_point now);
+
+  std::chrono::milliseconds m_period;
+  Source m_source;
+  std::chrono::steady_clock::time_point m_start;
+  std::chrono::steady_clock::time_point m_last_time;
+  uint64_t m_last_completed;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_notifier;
+  std::vector<PooleSample> m_ring;
+  std::size_t m_next = 0;
+  std::size_t m_size = 0;
+  bool m_stop = false;
+  std::thread m_thread;
+};
@@ -0,0 +1,91 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains PooleStats, a snapshot of the statistics of a pool, and
+ *          the exporters that turn it into JSON or OpenMetrics text. A snapshot
+ *          is taken without stopping the workers, and the exporters write into
+ *          a buffer owned by the caller, so a monitoring scrape never touches
+ *          the heap once its snapshot and buffer exist.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ThreadInfo.h"
+
+struct PooleStats {
+  uint32_t threads = 0;
+  uint64_t tasks_executed = 0;
+  uint64_t tasks_stolen = 0;
+  uint64_t spurious_wakeups = 0;
+  // Tasks submitted but not started, running now and not finished, and the
+  // deepest a queue has been
+  uint64_t pending = 0;
+  uint64_t running = 0;
+  uint64_t outstanding = 0;
+  uint64_t peak_pending = 0;
+  // Submitted closures too big to store inline, and the bytes they took
+  uint64_t task_allocations = 0;
+  uint64_t task_allocated_bytes = 0;
+  uint64_t uptime_ms = 0;
+  double utilization = 0.0;
+  // Task run times of all workers, see ThreadInfo::kTaskTimeBuckets
+  uint64_t task_time_buckets[ThreadInfo::kTaskTimeBuckets] = {};
+  // One entry per worker, empty when the pool keeps no statistics. Its
+  // capacity is kept between snapshots.
+  std::vector<ThreadSnapshot> workers;
+};
+
+/**
+ * @brief Get the name of a ThreadInfo::State as stored in a ThreadSnapshot
+ */
+const char* poole_state_name(uint8_t state);
+
+/**
+ * @brief Estimates a percentile of the task run times from their histogram
+ *
+ * @param buckets the ThreadInfo::kTaskTimeBuckets power-of-two buckets
+ * @param quantile the percentile wanted, between 0 and 1
+ * @return uint64_t the upper bound in nanoseconds of the bucket holding it,
+ *          0 when no task has finished
+ */
+uint64_t poole_task_time_percentile(const uint64_t* buckets, double quantile);
+
+/**
+ * @brief Writes the statistics as a single JSON object. Like snprintf, the
+ *          output is cut off to fit and always terminated.
+ *
+ * @param stats the snapshot to write
+ * @param buffer receives the text, it may be nullptr when size is 0
+ * @param size the size of the buffer in bytes
+ * @return std::size_t the length of the full text, a result of size or more
+ *          means the buffer was too small
+ */
+std::size_t format_json(const PooleStats& stats, char* buffer, std::size_t size);
+
+/**
+ * @brief Writes the statistics in the OpenMetrics text format, ending with
+ *          "# EOF", for a Prometheus scrape
+ *
+ * @return std::size_t the length of the full text, see format_json
+ */
+std::size_t format_openmetrics(const PooleStats& stats, char* buffer, std::size_t size);
@@ -0,0 +1,200 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains PooledFunction, the move-only task type of the default
+ *          Poole. Small callables are stored inside the object like in
+ *          InplaceFunction, bigger ones in a recycled TaskNodePool node instead
+ *          of a fresh heap block, so large closures stop paying for a malloc
+ *          on submission and a cross-thread free after running.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "TaskNodePool.h"
+
+template <std::size_t InlineBytes = 48>
+class PooledFunction {
+ public:
+  PooledFunction() noexcept = default;
+
+  /**
+   * @brief Stores a copy of the callable, inline when it fits
+   *
+   * @param callable is a lambda or any other void() callable
+   */
+  template <typename Callable,
+      typename = std::enable_if_t<!std::is_same<std::decay_t<Callable>, PooledFunction>::value>>
+  PooledFunction(Callable&& callable) {
+    using Stored = std::decay_t<Callable>;
+    static_assert(alignof(Stored) <= alignof(std::max_align_t), "The callable is over-aligned for a PooledFunction");
+
+    if constexpr (fits_inline<Stored>()) {
+      ::new (static_cast<void*>(&m_storage)) Stored(std::forward<Callable>(callable));
+      m_operations = &kInline<Stored>;
+    } else {
+      void* node = TaskNodePool::allocate(sizeof(Stored));
+      try {
+        ::new (node) Stored(std::forward<Callable>(callable));
+      } catch (...) {
+        TaskNodePool::deallocate(node, sizeof(Stored));
+        throw;
+      }
+      ::new (static_cast<void*>(&m_storage)) Stored*(static_cast<Stored*>(node));
+      m_operations = &kPooled<Stored>;
+    }
+  }
+
+  PooledFunction(PooledFunction&& other) noexcept {
+    take(other);
+  }
+
+  PooledFunction& operator=(PooledFunction&& other) noexcept {
+    if (this != &other) {
+      reset();
+      take(other);
+    }
+    return *this;
+  }
+
+  PooledFunction(const PooledFunction&) = delete;
+  PooledFunction& operator=(const PooledFunction&) = delete;
+
+  ~PooledFunction() {
+    reset();
+  }
+
+  /**
+   * @brief Calls the stored callable
+   */
+  void operator()() {
+    m_operations->invoke(&m_storage);
+  }
+
+  /**
+   * @brief Whether a callable is stored
+   */
+  explicit operator bool() const noexcept {
+    return m_operations != nullptr;
+  }
+
+  /**
+   * @brief Get the size of the node holding the callable, 0 when it is inline
+   */
+  std::size_t heap_bytes() const noexcept {
+    return m_operations != nullptr ? m_operations->heap_bytes : 0;
+  }
+
+  /**
+   * @brief Destroys the stored callable, if any
+   */
+  void reset() noexcept {
+    if (m_operations != nullptr) {
+      m_operations->destroy(&m_storage);
+      m_operations = nullptr;
+    }
+  }
+
+ private:
+  struct Operations {
+    void (*invoke)(void* storage);
+    void (*move)(void* from, void* to);
+    void (*destroy)(void* storage);
+    std::size_t heap_bytes;
+  };
+
+  template <typename Stored>
+  static constexpr bool fits_inline() {
+    // Moving a task must not throw, the queues rely on it
+    return sizeof(Stored) <= InlineBytes && std::is_nothrow_move_constructible<Stored>::value;
+  }
+
+  template <typename Stored>
+  static void invoke_inline(void* storage) {
+    (*static_cast<Stored*>(storage))();
+  }
+
+  template <typename Stored>
+  static void move_inline(void* from, void* to) {
+    ::new (to) Stored(std::move(*static_cast<Stored*>(from)));
+    static_cast<Stored*>(from)->~Stored();
+  }
+
+  template <typename Stored>
+  static void destroy_inline(void* storage) {
+    static_cast<Stored*>(storage)->~Stored();
+  }
+
+  // A pooled callable stays in its node, only the pointer to it moves
+  template <typename Stored>
+  static void invoke_pooled(void* storage) {
+    (**static_cast<Stored**>(storage))();
+  }
+
+  static void move_pooled(void* from, void* to) {
+    std::memcpy(to, from, sizeof(void*));
+  }
+
+  template <typename Stored>
+  static void destroy_pooled(void* storage) {
+    Stored* stored = *static_cast<Stored**>(storage);
+    stored->~Stored();
+    TaskNodePool::deallocate(stored, sizeof(Stored));
+  }
+
+  template <typename Stored>
+  static constexpr Operations kInline = {
+      &invoke_inline<Stored>, &move_inline<Stored>, &destroy_inline<Stored>, 0};
+
+  template <typename Stored>
+  static constexpr Operations kPooled = {
+      &invoke_pooled<Stored>, &move_pooled, &destroy_pooled<Stored>, sizeof(Stored)};
+
+  void take(PooledFunction& other) noexcept {
+    if (other.m_operations != nullptr) {
+      other.m_operations->move(&other.m_storage, &m_storage);
+      m_operations = other.m_operations;
+      other.m_operations = nullptr;
+    }
+  }
+
+  static_assert(InlineBytes >= sizeof(void*), "A PooledFunction needs room for a pointer");
+
+  alignas(std::max_align_t) unsigned char m_storage[InlineBytes];
+  const Operations* m_operations = nullptr;
+};
+
+/**
+ * @brief Get the bytes a task keeps outside of itself, for the pool statistics.
+ *          Only a PooledFunction can tell, any other task type reports 0.
+ */
+template <typename Task>
+std::size_t poole_task_heap_bytes(const Task& /*task*/) {
+  return 0;
+}
+
+template <std::size_t InlineBytes>
+std::size_t poole_task_heap_bytes(const PooledFunction<InlineBytes>& task) {
+  return task.heap_bytes();
+}
@@ -0,0 +1,192 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains the shared-memory statistics segment. A pool can
+ *          publish its PooleStats into a memory-mapped file at a fixed
+ *          interval, and any other process (such as poole-top) can map the
+ *          same file and read the numbers live, without a debugger or a
+ *          restart. The layout is versioned, and a reader refuses a segment
+ *          whose magic, version or size it does not know.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "PooleStats.h"
+
+namespace StatsSegment {
+
+constexpr uint32_t kMagic = 0x504F4F4C;  // "POOL"
+constexpr uint32_t kVersion = 3;
+constexpr uint32_t kMaxWorkers = 256;
+
+struct Worker {
+  uint32_t id;
+  uint32_t state;
+  uint64_t tasks;
+  uint64_t busy_ns;
+  uint64_t idle_ns;
+  uint64_t parked_ns;
+  uint64_t cpu_ns;
+};
+
+// The published numbers, copied out as a whole by a reader
+struct Data {
+  uint64_t published_ns;  // CLOCK_REALTIME, comparable between processes
+  uint64_t publish_count;
+  uint32_t threads;
+  uint32_t worker_count;  // The workers beyond kMaxWorkers are left out
+  uint64_t tasks_executed;
+  uint64_t tasks_stolen;
+  uint64_t spurious_wakeups;
+  uint64_t pending;
+  uint64_t running;
+  uint64_t outstanding;
+  uint64_t peak_pending;
+  uint64_t task_allocations;
+  uint64_t task_allocated_bytes;
+  uint64_t uptime_ms;
+  uint64_t task_time_buckets[ThreadInfo::kTaskTimeBuckets];
+  Worker workers[kMaxWorkers];
+};
+
+struct Layout {
+  // Written last when the segment is created
+  std::atomic<uint32_t> magic;
+  uint32_t version;
+  uint32_t layout_size;
+  uint32_t pid;
+  // A sequence lock, odd while the publisher is writing data
+  std::atomic<uint64_t> sequence;
+  Data data;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+    "The segment sequence must be lock-free to be shared between processes");
+
+/**
+ * @brief Creates (or replaces) the segment file and writes snapshots into it
+ */
+class Writer {
+ public:
+  Writer() = default;
+  ~Writer();
+  Writer(const Writer&) = delete;
+  Writer& operator=(const Writer&) = delete;
+
+  /**
+   * @brief Creates the file at path with the size of the layout and maps it
+   *
+   * @return true if the segment is ready, false if the file could not be
+   *          created or mapped
+   */
+  bool open(const std::string& path);
+
+  /**
+   * @brief Copies a snapshot into the segment
+   */
+  void write(const PooleStats& stats);
+
+  /**
+   * @brief Unmaps the segment and removes its file
+   */
+  void close();
+
+ private:
+  Layout* m_layout = nullptr;
+  std::string m_path;
+};
+
+/**
+ * @brief Maps an existing segment read-only
+ */
+class Reader {
+ public:
+  Reader() = default;
+  ~Reader();
+  Reader(const Reader&) = delete;
+  Reader& operator=(const Reader&) = delete;
+
+  /**
+   * @brief Maps the segment at path and checks its layout
+   *
+   * @return true if the segment exists and has a layout this reader knows
+   */
+  bool open(const std::string& path);
+
+  /**
+   * @brief Copies out a consistent view of the published numbers
+   *
+   * @return true once a copy was made between two publications, false if the
+   *          segment is not open or nothing was published yet
+   */
+  bool read(Data& data) const;
+
+  /**
+   * @brief Get the process id of the publishing process
+   */
+  uint32_t pid() const;
+
+  void close();
+
+ private:
+  const Layout* m_layout = nullptr;
+};
+
+/**
+ * @brief Samples statistics on its own thread and writes them into a segment
+ *          at a fixed interval until it is destroyed
+ */
+class Publisher {
+ public:
+  using Sampler = std::function<void(PooleStats&)>;
+
+  Publisher(const std::string& path, std::chrono::milliseconds interval, Sampler sampler);
+  ~Publisher();
+  Publisher(const Publisher&) = delete;
+  Publisher& operator=(const Publisher&) = delete;
+
+  /**
+   * @brief Whether the segment could be created
+   */
+  bool is_open() const;
+
+ private:
+  void run();
+
+  Writer m_writer;
+  bool m_open;
+  std::chrono::milliseconds m_interval;
+  Sampler m_sampler;
+  PooleStats m_stats;
+  std::mutex m_mutex;
+  std::condition_variable m_notifier;
+  bool m_stop = false;
+  std::thread m_thread;
+};
+
+}  // namespace StatsSegment
@@ -0,0 +1,191 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains BasicStrand, a serial executor on top of a Poole. The
+ *          tasks of one strand run one at a time and in submission order, but
+ *          on whichever worker is free, while different strands run in
+ *          parallel. A strand only occupies a worker while it has tasks.
+ *          Its queue nodes come from the TaskNodePool, and the tasks waiting
+ *          in it count as pending tasks of the pool.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "PoolePolicies.h"
+#include "TaskNodePool.h"
+#include "Watchdog.h"
+
+template <typename Pool>
+class BasicStrand {
+ public:
+  using task_type = typename Pool::task_type;
+
+  /**
+   * @brief Construct a new strand on the pool. The pool must outlive every
+   *          task submitted to the strand.
+   */
+  explicit BasicStrand(Pool& pool) : m_state(std::make_shared<State>(pool)) {}
+
+  /**
+   * @brief Adds a function to the strand. It runs after every function added
+   *          to this strand before it, and never at the same time as them.
+   *          Submitting never takes a lock.
+   *
+   * @param function_to_add is a lambda or a void function to execute
+   * @param site where the task comes from, the caller unless labelled
+   */
+  void add_function(task_type function_to_add, TaskSite site = TaskSite::current()) {
+    // Counted before it can run, so the pool's pending tasks include the
+    // strand's backlog and wait() waits for it
+    m_state->m_pool.m_outstanding.fetch_add(1);
+    m_state->push(new Node(std::move(function_to_add), site, m_state->m_pool.submit_time_ns()));
+
+    // The submitter that finds the strand empty schedules it on the pool. The
+    // task draining it is counted too and stands in for this one.
+    if (m_state->m_count.fetch_add(1, std::memory_order_acq_rel) == 0) {
+      schedule(m_state, site);
+      m_state->m_pool.finish_task();
+    }
+  }
+
+ private:
+  // The number of tasks a strand runs in a row before letting other work onto
+  // its worker
+  static constexpr uint32_t kBatchSize = 64;
+
+  struct Node {
+    Node() = default;
+    Node(task_type function, const TaskSite& site, uint64_t submit_ns)
+        : function(std::move(function)), site(site), submit_ns(submit_ns) {}
+
+    // Recycled like the task closures, a strand task costs no heap allocation
+    static void* operator new(std::size_t bytes) { return TaskNodePool::allocate(bytes); }
+    static void operator delete(void* memory, std::size_t bytes) noexcept {
+      TaskNodePool::deallocate(memory, bytes);
+    }
+
+    std::atomic<Node*> next{nullptr};
+    task_type function;
+    // Every task is reported under its own site, not the one that scheduled
+    // the strand
+    TaskSite site;
+    uint64_t submit_ns = 0;
+  };
+
+  /**
+   * @brief The shared state of a strand: an intrusive multi-producer single-
+   *          consumer queue and a count of the tasks that have not finished
+   */
+  struct State {
+    explicit State(Pool& pool) : m_pool(pool), m_head(&m_stub), m_tail(&m_stub) {}
+
+    ~State() {
+      // Tasks only remain if the pool stopped before running them
+      while (Node* node = pop()) {
+        delete node;
+      }
+    }
+
+    void push(Node* node) {
+      node->next.store(nullptr, std::memory_order_relaxed);
+      Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+      previous->next.store(node, std::memory_order_release);
+    }
+
+    // Only the single running consumer may pop. Returns nullptr when the
+    // queue is empty or a producer has not finished linking its node yet.
+    Node* pop() {
+      Node* tail = m_tail;
+      Node* next = tail->next.load(std::memory_order_acquire);
+      if (tail == &m_stub) {
+        if (next == nullptr) {
+          return nullptr;
+        }
+        m_tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+      }
+      if (next != nullptr) {
+        m_tail = next;
+        return tail;
+      }
+      if (tail != m_head.load(std::memory_order_acquire)) {
+        return nullptr;
+      }
+      push(&m_stub);
+      next = tail->next.load(std::memory_order_acquire);
+      if (next != nullptr) {
+        m_tail = next;
+        return tail;
+      }
+      return nullptr;
+    }
+
+    Pool& m_pool;
+    std::atomic<uint64_t> m_count{0};
+    Node m_stub;
+    std::atomic<Node*> m_head;
+    Node* m_tail;
+  };
+
+  // The task draining the strand is a relay, each task it runs is reported
+  // under its own site
+  static void schedule(const std::shared_ptr<State>& state, const TaskSite& site) {
+    TaskSite relay = TaskSite::relayed(site);
+    state->m_pool.add_function([state, relay]() { run(state, relay); }, relay);
+  }
+
+  // A strand that ran a full batch queues up behind the rest of the pool's work
+  static void reschedule(const std::shared_ptr<State>& state, const TaskSite& site) {
+    state->m_pool.add_function_shared([state, site]() { run(state, site); }, site);
+  }
+
+  static void run(const std::shared_ptr<State>& state, const TaskSite& site) {
+    for (uint32_t completed = 1;; ++completed) {
+      Node* node = state->pop();
+      while (node == nullptr) {
+        // The task is counted, its producer is just between its two stores
+        poole_cpu_relax();
+        node = state->pop();
+      }
+
+      state->m_pool.run_as(node->site, node->submit_ns, node->function);
+      delete node;
+
+      // Leave the worker as soon as the strand is empty, the next submitter
+      // will schedule it again. The last task is counted by this one.
+      if (state->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        return;
+      }
+      state->m_pool.finish_task();
+      if (completed == kBatchSize) {
+        reschedule(state, site);
+        return;
+      }
+    }
+  }
+
+  std::shared_ptr<State> m_state;
+};
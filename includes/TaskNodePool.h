@@ -0,0 +1,70 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains TaskNodePool, the recycled storage for task closures
+ *          too big to be stored inline. A closure is allocated by its submitter
+ *          and freed by whichever worker ran it, the worst case for a general
+ *          purpose allocator. Here freed nodes collect in the freeing thread's
+ *          cache and travel back to the submitters in batches, through one
+ *          lock per batch rather than per node.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace TaskNodePool {
+
+// Nodes come in power-of-two size classes from kMinNode to kMaxNode bytes,
+// anything bigger goes straight to operator new
+constexpr std::size_t kMinNode = 64;
+constexpr std::size_t kMaxNode = 2048;
+constexpr std::size_t kClassCount = 6;
+// The nodes moved between a thread's cache and the shared lists at once
+constexpr uint32_t kBatch = 32;
+// The batches kept per size class in the shared lists, enough for the next
+// burst of a couple of thousand tasks. Nodes freed beyond that go back to
+// operator delete, so a single burst does not keep its memory for good.
+constexpr std::size_t kMaxSharedBatches = 64;
+
+/**
+ * @brief Get a node of at least bytes, aligned like operator new
+ */
+void* allocate(std::size_t bytes);
+
+/**
+ * @brief Returns a node to the calling thread's cache
+ *
+ * @param bytes the size passed to allocate()
+ */
+void deallocate(void* memory, std::size_t bytes) noexcept;
+
+/**
+ * @brief Get the number of nodes that had to come from operator new
+ */
+uint64_t fresh_nodes();
+
+/**
+ * @brief Get the number of nodes given back to operator delete because the
+ *          shared lists were full
+ */
+uint64_t released_nodes();
+
+}  // namespace TaskNodePool
@@ -16,59 +16,118 @@
 /**
  * @author: Benrick Smit
  * @date: 20 June 2020
- * @modified: 2 December 2020
+ * @modified: 19 October 2026
  * 
  * @brief: This contains the interface and header information for the ThreadInfo
  * 			class responsible for storing statistics about the jobs performed
- * 			by the thread pool class Poole.
+ * 			by the thread pool class Poole. Every field is atomic, so other
+ * 			threads can read the statistics while the worker updates them.
+ * 			The worker also accounts where its time goes: running tasks
+ * 			(busy), looking for work (idle) or asleep (parked).
  * 
  */
 
 #pragma once
 
 #include <string>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <type_traits> // Added for std::invoke_result_t or similar usage earlier, keeping it for robustness
  
 #include "ThreadInfo.h"
 
-class ThreadInfo{
+// The statistics of one thread, read together at a single point in time
+struct ThreadSnapshot{
+	uint32_t id = 0;
+	uint8_t state = 0;
+	uint64_t tasks = 0;
+	uint64_t uptime_ms = 0;
+	uint64_t busy_ns = 0;
+	uint64_t idle_ns = 0;
+	uint64_t parked_ns = 0;
+	uint64_t cpu_ns = 0;
+	double utilization = 0.0;
+};
+
+// Aligned to a cache line so that workers never share one
+class alignas(64) ThreadInfo{
 	public:
+	// What the worker is doing, the time spent in each state is accumulated
+		enum class State : uint8_t { Busy = 0, Idle = 1, Parked = 2, Stopped = 3 };
+
+	// Task run times are counted in power-of-two buckets of nanoseconds,
+	// bucket i holds the tasks that took less than 2^(i+1) ns
+		static constexpr int kTaskTimeBuckets = 40;
+
 	// Constructor
 		ThreadInfo();
+		ThreadInfo(const ThreadInfo&) = delete;
+		ThreadInfo& operator=(const ThreadInfo&) = delete;
 
 	// Getters
 		bool is_busy() const;
 		uint32_t get_ID() const;
 		bool is_done() const;
-		uint32_t get_uptime() const;
+		uint64_t get_uptime() const;
 		uint64_t get_tasks() const;
+		State get_state() const;
+		uint64_t get_busy_time() const;
+		uint64_t get_idle_time() const;
+		uint64_t get_parked_time() const;
+		uint64_t get_cpu_time() const;
+		double get_utilization() const;
+		double get_cpu_utilization() const;
+		ThreadSnapshot snapshot() const;
+		void add_task_times(uint64_t* buckets) const;
 		
 	// Setters
 		void set_busy(bool con = false);
 		void set_done(bool con = false);
 		void set_ID(uint16_t id);
+		void set_state(State state);
 		
 	// Others
 		void add_task(uint32_t total_tasks = 1);
+		void attach_to_current_thread();
+		void detach_from_current_thread();
 		std::string to_string();
 
 	protected:
 	// Getters
-		std::chrono::system_clock::time_point get_start_time() const;
+		std::chrono::steady_clock::time_point get_start_time() const;
+		uint64_t get_state_time(State state) const;
+		uint64_t now_ns() const;
 
 	// Setters
+		void begin_update();
+		void end_update();
 		void set_uptime();
-		void set_tasks(uint32_t total_tasks = 0);
+		void set_tasks(uint64_t total_tasks = 0);
 
 
 	private:
-	bool m_thread_is_busy;
-	bool m_thread_is_done;
+	// A sequence lock around the task count and the state times. It is odd
+	// while the worker updates them, so a reader can retry instead of
+	// mixing two updates.
+	std::atomic<uint32_t> m_sequence;
+	std::atomic<bool> m_thread_is_busy;
+	std::atomic<bool> m_thread_is_done;
 	int m_thread_ID;
-	std::chrono::system_clock::time_point m_start_time_ms;
-	unsigned long long m_total_tasks;
-	char _padding[40]; // Manual padding to prevent false sharing, assuming 64-byte cache lines
-};
+	std::chrono::steady_clock::time_point m_start_time_ms;
+	std::atomic<uint64_t> m_total_tasks;
+
+	// Nanoseconds spent in each state, not counting the current one, which
+	// started m_state_since nanoseconds after m_start_time_ms
+	std::atomic<uint8_t> m_state;
+	std::atomic<uint64_t> m_state_since;
+	std::atomic<uint64_t> m_state_time[3];
+	std::atomic<uint64_t> m_task_time[kTaskTimeBuckets];
 
+	// The CPU clock of the worker thread while it runs, and the CPU time of
+	// the threads that ran this worker before and have exited
+	std::atomic<bool> m_cpu_clock_valid;
+	std::atomic<long> m_cpu_clock;
+	std::atomic<uint64_t> m_cpu_time;
+};
@@ -0,0 +1,225 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains TaskSite, the place a task was submitted from, and the
+ *          Watchdog that flags tasks that run or wait too long. Every flagged
+ *          task is added to the totals of its callsite, so a drop in
+ *          throughput can be traced back to the submitter whose tasks hog the
+ *          workers. The watchdog costs one relaxed load per task while it is
+ *          disabled.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Where a task was submitted. It is captured by a default argument, so
+ *          a plain add_function() call records its own file, line and function.
+ *          A label can name a callsite explicitly, e.g. for tasks submitted
+ *          from a shared helper. Every string must outlive the pool, which
+ *          string literals do.
+ */
+struct TaskSite {
+  const char* file = "";
+  const char* function = "";
+  const char* label = nullptr;
+  uint32_t line = 0;
+  // Set on tasks that only run other tasks, e.g. a strand draining its queue.
+  // The pool reports the tasks they run under their own sites instead.
+  bool relay = false;
+
+  /**
+   * @brief Get the site of the caller
+   */
+  static TaskSite current(const char* file = __builtin_FILE(), const char* function = __builtin_FUNCTION(),
+      uint32_t line = __builtin_LINE()) noexcept {
+    TaskSite site;
+    site.file = file;
+    site.function = function;
+    site.line = line;
+    return site;
+  }
+
+  /**
+   * @brief Get the site of the caller, named by label
+   */
+  static TaskSite labelled(const char* label, const char* file = __builtin_FILE(),
+      const char* function = __builtin_FUNCTION(), uint32_t line = __builtin_LINE()) noexcept {
+    TaskSite site = current(file, function, line);
+    site.label = label;
+    return site;
+  }
+
+  /**
+   * @brief Get site marked as a relay
+   */
+  static TaskSite relayed(TaskSite site) noexcept {
+    site.relay = true;
+    return site;
+  }
+};
+
+/**
+ * @brief A task the watchdog flagged, passed to WatchdogConfig::on_slow_task
+ */
+struct SlowTask {
+  enum class Kind { SlowRun, SlowWait, StillRunning };
+
+  Kind kind = Kind::SlowRun;
+  TaskSite site;
+  uint32_t worker = 0;
+  // The time the task waited in a queue (0 if unknown) and has run so far
+  uint64_t wait_ns = 0;
+  uint64_t run_ns = 0;
+};
+
+/**
+ * @brief The flagged tasks of one callsite
+ */
+struct CallsiteReport {
+  TaskSite site;
+  uint64_t slow_runs = 0;
+  uint64_t slow_waits = 0;
+  // Tasks caught while still running past the threshold
+  uint64_t still_running = 0;
+  uint64_t total_run_ns = 0;
+  uint64_t max_run_ns = 0;
+  uint64_t total_wait_ns = 0;
+  uint64_t max_wait_ns = 0;
+};
+
+struct WatchdogConfig {
+  // A task that runs longer than this is flagged, 0 turns the check off
+  std::chrono::nanoseconds run_threshold = std::chrono::milliseconds(100);
+  // A task that waited longer than this before starting is flagged
+  std::chrono::nanoseconds wait_threshold = std::chrono::milliseconds(100);
+  // How often running tasks are checked, so a stuck task is reported before
+  // it finishes
+  std::chrono::milliseconds scan_interval = std::chrono::milliseconds(50);
+  // Called for every flagged task, from the worker or the watchdog thread
+  std::function<void(const SlowTask&)> on_slow_task;
+};
+
+class Watchdog {
+ public:
+  explicit Watchdog(uint32_t total_workers);
+  ~Watchdog();
+  Watchdog(const Watchdog&) = delete;
+  Watchdog& operator=(const Watchdog&) = delete;
+
+  /**
+   * @brief Starts (or reconfigures) the watchdog and its scanning thread
+   */
+  void enable(const WatchdogConfig& config);
+
+  /**
+   * @brief Stops the watchdog, the collected report is kept
+   */
+  void disable();
+
+  bool enabled() const {
+    return m_enabled.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the clock the watchdog measures with, in nanoseconds
+   */
+  static uint64_t now_ns();
+
+  /**
+   * @brief Called by a worker right before it runs a task
+   *
+   * @param submit_ns when the task was submitted, 0 if the watchdog was off
+   */
+  void task_started(uint32_t worker, const TaskSite& site, uint64_t submit_ns);
+
+  /**
+   * @brief Called by the same worker right after the task
+   */
+  void task_finished(uint32_t worker);
+
+  // What a worker's slot held, set aside while a task runs nested in another
+  struct Suspended {
+    uint64_t start_ns = 0;
+    uint64_t wait_ns = 0;
+    TaskSite site;
+    bool flagged = false;
+  };
+
+  /**
+   * @brief Called by a worker before a task it runs inside another task, so
+   *          the outer one keeps its site and start time
+   */
+  Suspended suspend(uint32_t worker) const;
+
+  /**
+   * @brief Called by the same worker after the nested task
+   */
+  void resume(uint32_t worker, const Suspended& task);
+
+  /**
+   * @brief Get the flagged totals per callsite, sorted by file and line
+   */
+  std::vector<CallsiteReport> report() const;
+
+  /**
+   * @brief Forgets every flagged task
+   */
+  void reset();
+
+ private:
+  // What a worker is running, readable by the scanning thread
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> start_ns{0};
+    std::atomic<uint64_t> wait_ns{0};
+    std::atomic<const char*> file{nullptr};
+    std::atomic<const char*> function{nullptr};
+    std::atomic<const char*> label{nullptr};
+    std::atomic<uint32_t> line{0};
+    std::atomic<bool> flagged{false};
+  };
+
+  void scan();
+  void flag(const SlowTask& task);
+  static TaskSite read_site(const Slot& slot);
+
+  uint32_t m_slot_count;
+  std::unique_ptr<Slot[]> m_slots;
+  std::atomic<bool> m_enabled{false};
+  std::atomic<uint64_t> m_run_threshold{0};
+  std::atomic<uint64_t> m_wait_threshold{0};
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_notifier;
+  WatchdogConfig m_config;
+  std::map<std::string, CallsiteReport> m_callsites;
+  bool m_stop = false;
+  std::thread m_thread;
+};
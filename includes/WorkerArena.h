@@ -0,0 +1,105 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains WorkerArena, the bump allocator every worker owns.
+ *          Tasks allocate their short-lived containers from it through
+ *          std::pmr, and the worker rewinds it after each task, so those
+ *          allocations never reach malloc or contend with other workers.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+class WorkerArena : public std::pmr::memory_resource {
+ public:
+  // The size of the first chunk, allocated on first use
+  static constexpr std::size_t kDefaultSize = 64 * 1024;
+
+  explicit WorkerArena(std::size_t initial_size = kDefaultSize);
+  ~WorkerArena() override;
+  WorkerArena(const WorkerArena&) = delete;
+  WorkerArena& operator=(const WorkerArena&) = delete;
+
+  /**
+   * @brief Frees everything allocated since the last reset. An arena that grew
+   *          is merged into a single chunk, so the next task of the same size
+   *          needs no new memory. Free when nothing was allocated.
+   */
+  void reset() {
+    if (m_used != 0){
+      rewind();
+    }
+  }
+
+  /**
+   * @brief Get the number of bytes handed out since the last reset
+   */
+  std::size_t used() const {
+    return m_used;
+  }
+
+  /**
+   * @brief Get the number of bytes the arena holds across all its chunks
+   */
+  std::size_t capacity() const {
+    return m_capacity;
+  }
+
+  /**
+   * @brief Get the arena of the worker running on this thread, or the default
+   *          new/delete resource when called from any other thread
+   */
+  static std::pmr::memory_resource* current();
+
+  /**
+   * @brief Makes arena the one current() returns on this thread
+   */
+  static void set_current(WorkerArena* arena);
+
+ protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  // Memory is only given back by reset()
+  void do_deallocate(void* /*memory*/, std::size_t /*bytes*/, std::size_t /*alignment*/) override {}
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+ private:
+  struct Chunk {
+    Chunk* next;
+    std::size_t size;
+  };
+
+  void grow(std::size_t minimum);
+  void rewind();
+  void release();
+  static char* data(Chunk* chunk) {
+    return reinterpret_cast<char*>(chunk + 1);
+  }
+
+  std::size_t m_initial_size;
+  // The newest chunk first, allocations come from it
+  Chunk* m_chunks = nullptr;
+  char* m_cursor = nullptr;
+  char* m_end = nullptr;
+  std::size_t m_used = 0;
+  std::size_t m_capacity = 0;
+};
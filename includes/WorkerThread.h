@@ -0,0 +1,116 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains WorkerConfig, everything about the worker threads that
+ *          is fixed when a pool is constructed, and WorkerThread, which starts
+ *          a thread with those attributes. On Linux the workers are named,
+ *          can get a smaller stack, a nice value and a batch or idle
+ *          scheduling policy. Elsewhere they are plain std::threads. A
+ *          pool can also start its workers lazily and retire idle ones.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+#include "Watchdog.h"
+
+/**
+ * @brief Callbacks run by every worker, e.g. to set up thread-local state or
+ *          to feed a profiler. They are fixed when the pool is constructed, so
+ *          on_worker_start runs before a worker takes its first task. A hook
+ *          that is not set costs one predictable branch.
+ */
+struct WorkerHooks {
+  // Called on the worker thread when it starts and right before it exits
+  std::function<void(uint32_t worker_id)> on_worker_start;
+  std::function<void(uint32_t worker_id)> on_worker_stop;
+  // Called on the worker thread around every task
+  std::function<void(uint32_t worker_id, const TaskSite& site)> before_task;
+  std::function<void(uint32_t worker_id, const TaskSite& site)> after_task;
+};
+
+enum class SchedulingPolicy {
+  Default,  // Whatever the creating thread uses
+  Batch,    // SCHED_BATCH, for throughput work that should not preempt others
+  Idle      // SCHED_IDLE, only runs when nothing else wants the CPU
+};
+
+struct WorkerConfig {
+  // Workers are named "<prefix>-<id>", cut to the 15 characters Linux keeps
+  std::string name_prefix = "poole";
+  // The stack of every worker in bytes, 0 keeps the system default
+  std::size_t stack_size = 0;
+  // The nice value of every worker, unset keeps the creating thread's
+  std::optional<int> nice;
+  SchedulingPolicy scheduling = SchedulingPolicy::Default;
+  // Start workers only when queued work needs them instead of all up front
+  bool lazy_spawn = false;
+  // A worker idle for this long exits until work needs it again, 0 never
+  std::chrono::milliseconds idle_timeout{0};
+  // Lets an explicit thread count exceed the hardware threads, for pools
+  // whose tasks mostly wait on I/O
+  bool allow_oversubscription = false;
+  // Extra workers, started on demand, that take the place of workers blocked
+  // in a BlockingRegion. Without spares a region is only counted,
+  // kSparePerWorker gives every worker one.
+  static constexpr uint32_t kSparePerWorker = UINT32_MAX;
+  uint32_t blocking_spares = 0;
+  WorkerHooks hooks;
+};
+
+class WorkerThread {
+ public:
+  WorkerThread() = default;
+  WorkerThread(WorkerThread&& other) noexcept;
+  WorkerThread& operator=(WorkerThread&& other) noexcept;
+  WorkerThread(const WorkerThread&) = delete;
+  WorkerThread& operator=(const WorkerThread&) = delete;
+  ~WorkerThread();
+
+  /**
+   * @brief Starts a thread running body with the attributes of config. An
+   *          attribute the system refuses is dropped rather than failing.
+   *
+   * @param id the worker id, used in the thread name
+   */
+  WorkerThread(const WorkerConfig& config, uint32_t id, std::function<void()> body);
+
+  bool joinable() const;
+  void join();
+
+ private:
+#if defined(__linux__)
+  pthread_t m_handle{};
+  bool m_joinable = false;
+#else
+  std::thread m_thread;
+#endif
+};
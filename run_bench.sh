@@ -0,0 +1,32 @@
+#!/usr/bin/env bash
+##-------------------------------------------------------------------------------------------------
+## HEADER INFORMATION
+##-------------------------------------------------------------------------------------------------
+## This Shell Script is used to obtain the benchmark filename from build_name.txt in build_info
+## after which it will execute it. Any arguments after the build type are passed on to the
+## benchmark, e.g. ./run_bench.sh Release --format json --output bench_output.txt
+
+## Read the filename from the chosen location
+PROJECT_NAME=$(cat build_info/build_name.txt)
+
+# Determine the build type (Debug, Release, etc.)
+BUILD_TYPE=${1:-"Debug"} # Default to Debug if no argument is provided
+shift
+
+# Construct the expected name for the benchmark executable
+if [[ "$OSTYPE" == "msys" || "$OSTYPE" == "win32" ]]; then
+    BENCH_EXECUTABLE_NAME="${PROJECT_NAME}_bench.exe"
+else
+    BENCH_EXECUTABLE_NAME="${PROJECT_NAME}_bench"
+fi
+
+# Search for the benchmark executable in the build directory
+BENCH_EXECUTABLE_PATH=$(find ./build -name "${BENCH_EXECUTABLE_NAME}" -type f 2>/dev/null | grep "${BUILD_TYPE}" | head -n 1)
+
+if [ -z "${BENCH_EXECUTABLE_PATH}" ]; then
+    echo "Error: Benchmark executable not found. Tried searching for ${BENCH_EXECUTABLE_NAME} in ./build/${BUILD_TYPE}/ or similar."
+    exit 1
+fi
+
+echo "Running benchmarks: ${BENCH_EXECUTABLE_PATH}"
+"${BENCH_EXECUTABLE_PATH}" "$@"
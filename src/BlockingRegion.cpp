@@ -0,0 +1,56 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+*/
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains the implementation of BlockingRegion
+ *
+ */
+
+#include "BlockingRegion.h"
+
+#include <cstdint>
+
+namespace {
+
+thread_local BlockingRegion::Handler* t_current_handler = nullptr;
+thread_local uint32_t t_depth = 0;
+
+}  // namespace
+
+BlockingRegion::BlockingRegion() : m_handler(nullptr) {
+    // Only the outermost region tells the pool
+    if (t_depth++ == 0 && t_current_handler != nullptr){
+        m_handler = t_current_handler;
+        m_handler->enter();
+    }
+}
+
+BlockingRegion::~BlockingRegion() {
+    t_depth--;
+    if (m_handler != nullptr){
+        m_handler->leave();
+    }
+}
+
+bool BlockingRegion::active() {
+    return t_depth > 0;
+}
+
+void BlockingRegion::set_current(Handler* handler) {
+    t_current_handler = handler;
+}
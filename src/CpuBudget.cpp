@@ -0,0 +1,291 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+*/
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains the implementation of CpuBudget and ThrottleWatch
+ *
+ */
+
+#include "CpuBudget.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace {
+
+// Reads the first line of a file, false if it cannot be opened
+bool read_line(const std::string& path, std::string& line) {
+    std::ifstream file(path);
+    return static_cast<bool>(file) && static_cast<bool>(std::getline(file, line));
+}
+
+// Reads a file that holds a single integer
+std::optional<int64_t> read_integer(const std::string& path) {
+    std::string line;
+    if (!read_line(path, line)){
+        return std::nullopt;
+    }
+    std::istringstream stream(line);
+    int64_t value = 0;
+    if (!(stream >> value)){
+        return std::nullopt;
+    }
+    return value;
+}
+
+// The CPUs one cgroup directory allows, unset when it sets no limit
+std::optional<double> directory_quota(const std::string& directory, bool unified) {
+    if (unified){
+        // "max 100000" or "<quota> <period>", both in microseconds
+        std::string line;
+        if (!read_line(directory + "/cpu.max", line)){
+            return std::nullopt;
+        }
+        std::istringstream stream(line);
+        std::string quota;
+        int64_t period = 0;
+        if (!(stream >> quota >> period) || quota == "max" || period <= 0){
+            return std::nullopt;
+        }
+        int64_t quota_us = std::strtoll(quota.c_str(), nullptr, 10);
+        if (quota_us <= 0){
+            return std::nullopt;
+        }
+        return static_cast<double>(quota_us) / static_cast<double>(period);
+    }
+    // cgroup v1 writes -1 for an unlimited quota
+    auto quota_us = read_integer(directory + "/cpu.cfs_quota_us");
+    auto period_us = read_integer(directory + "/cpu.cfs_period_us");
+    if (!quota_us || !period_us || *quota_us <= 0 || *period_us <= 0){
+        return std::nullopt;
+    }
+    return static_cast<double>(*quota_us) / static_cast<double>(*period_us);
+}
+
+}  // namespace
+
+CpuBudget::CpuBudget(std::string root) : m_root(std::move(root)) {
+    // Paths are appended to the root, so drop a trailing slash
+    while (m_root.size() > 1 && m_root.back() == '/'){
+        m_root.pop_back();
+    }
+    if (m_root == "/"){
+        m_root.clear();
+    }
+}
+
+std::string CpuBudget::cgroup_directory(bool& unified, std::string& hierarchy) const {
+    // Every line of /proc/self/cgroup is "<id>:<controllers>:<path>". The v2
+    // hierarchy has id 0 and no controllers, v1 lists the cpu controller.
+    std::ifstream file(m_root + "/proc/self/cgroup");
+    std::string line;
+    std::string v1_directory;
+    std::string v1_hierarchy;
+    while (std::getline(file, line)){
+        auto first = line.find(':');
+        auto second = line.find(':', first + 1);
+        if (first == std::string::npos || second == std::string::npos){
+            continue;
+        }
+        std::string controllers = line.substr(first + 1, second - first - 1);
+        std::string path = line.substr(second + 1);
+        if (path == "/"){
+            path.clear();
+        }
+        if (line.compare(0, first, "0") == 0 && controllers.empty()){
+            // Inside a container the path can name the host's view of the
+            // cgroup, which is then mounted as the root
+            std::string mount = m_root + "/sys/fs/cgroup";
+            for (const std::string& directory : {mount + path, mount}){
+                if (std::ifstream(directory + "/cpu.max") || std::ifstream(directory + "/cpu.stat")){
+                    unified = true;
+                    hierarchy = mount;
+                    return directory;
+                }
+            }
+            continue;
+        }
+        std::stringstream list(controllers);
+        std::string controller;
+        while (std::getline(list, controller, ',')){
+            if (controller != "cpu"){
+                continue;
+            }
+            // The controller is mounted under its own name or its whole list
+            for (const std::string& mount : {m_root + "/sys/fs/cgroup/" + controllers, m_root + "/sys/fs/cgroup/cpu"}){
+                for (const std::string& directory : {mount + path, mount}){
+                    if (v1_directory.empty() && std::ifstream(directory + "/cpu.cfs_quota_us")){
+                        v1_directory = directory;
+                        v1_hierarchy = mount;
+                    }
+                }
+            }
+        }
+    }
+    unified = false;
+    hierarchy = v1_hierarchy;
+    return v1_directory;
+}
+
+std::optional<double> CpuBudget::quota() const {
+    bool unified = false;
+    std::string hierarchy;
+    std::string directory = cgroup_directory(unified, hierarchy);
+    if (directory.empty()){
+        return std::nullopt;
+    }
+
+    // A parent's limit holds for all of its children, so walk up to the
+    // hierarchy's root and keep the tightest
+    std::optional<double> tightest;
+    while (true){
+        if (auto cpus = directory_quota(directory, unified)){
+            tightest = tightest ? std::min(*tightest, *cpus) : *cpus;
+        }
+        if (directory.size() <= hierarchy.size()){
+            break;
+        }
+        directory = directory.substr(0, directory.rfind('/'));
+    }
+    return tightest;
+}
+
+uint32_t CpuBudget::affinity() const {
+#if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0){
+        return static_cast<uint32_t>(CPU_COUNT(&mask));
+    }
+#endif
+    return 0;
+}
+
+uint32_t CpuBudget::threads() const {
+    uint32_t threads = std::thread::hardware_concurrency();
+    if (uint32_t mask = affinity()){
+        threads = threads == 0 ? mask : std::min(threads, mask);
+    }
+    if (auto cpus = quota()){
+        // A quota of 2.5 CPUs keeps 3 threads busy most of the time
+        threads = std::min<uint32_t>(threads == 0 ? UINT32_MAX : threads,
+                static_cast<uint32_t>(std::ceil(*cpus)));
+    }
+    return std::max(1u, threads);
+}
+
+std::optional<CpuThrottle> CpuBudget::throttle() const {
+    bool unified = false;
+    std::string hierarchy;
+    std::string directory = cgroup_directory(unified, hierarchy);
+    std::ifstream file(directory + "/cpu.stat");
+    if (directory.empty() || !file){
+        return std::nullopt;
+    }
+
+    // v2 reports throttled_usec, v1 throttled_time in nanoseconds
+    CpuThrottle to_return;
+    std::string key;
+    uint64_t value = 0;
+    while (file >> key >> value){
+        if (key == "nr_periods"){
+            to_return.periods = value;
+        } else if (key == "nr_throttled"){
+            to_return.throttled_periods = value;
+        } else if (key == "throttled_usec"){
+            to_return.throttled_ns = value * 1000;
+        } else if (key == "throttled_time"){
+            to_return.throttled_ns = value;
+        }
+    }
+    return to_return;
+}
+
+uint32_t CpuBudget::default_threads() {
+    static const uint32_t threads = CpuBudget().threads();
+    return threads;
+}
+
+ThrottleWatch::ThrottleWatch(CpuBudget budget, uint32_t max_threads, std::chrono::milliseconds interval, Apply apply)
+    : m_budget(std::move(budget)), m_max_threads(std::max(1u, max_threads)),
+      m_interval(std::max(interval, std::chrono::milliseconds(1))), m_apply(std::move(apply)),
+      m_last(m_budget.throttle()), m_threads(m_max_threads) {
+    m_thread = std::thread([this](){ run(); });
+}
+
+ThrottleWatch::~ThrottleWatch() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_notifier.notify_all();
+    if (m_thread.joinable()){
+        m_thread.join();
+    }
+}
+
+uint32_t ThrottleWatch::poll() {
+    auto now = m_budget.throttle();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    uint32_t before = m_threads;
+    if (now && m_last && now->periods >= m_last->periods && now->throttled_periods >= m_last->throttled_periods){
+        uint64_t periods = now->periods - m_last->periods;
+        uint64_t throttled = now->throttled_periods - m_last->throttled_periods;
+        if (periods > 0 && static_cast<double>(throttled) > kThrottledShare * static_cast<double>(periods)){
+            // The quota keeps running out, fewer runnable workers use less of it
+            m_threads = std::max(1u, m_threads - 1);
+            m_calm = 0;
+        } else if (m_threads < m_max_threads && ++m_calm >= kCalmPolls){
+            m_threads++;
+            m_calm = 0;
+        }
+    }
+    m_last = now;
+    uint32_t threads = m_threads;
+    lock.unlock();
+
+    if (threads != before && m_apply){
+        m_apply(threads);
+    }
+    return threads;
+}
+
+uint32_t ThrottleWatch::threads() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_threads;
+}
+
+void ThrottleWatch::run() {
+    auto next = std::chrono::steady_clock::now() + m_interval;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_notifier.wait_until(lock, next, [this](){ return m_stop; })){
+        lock.unlock();
+        poll();
+        lock.lock();
+        next += m_interval;
+    }
+}
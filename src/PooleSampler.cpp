@@ -0,0 +1,100 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+*/
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains the implementation of PooleSampler
+ *
+ */
+
+#include "PooleSampler.h"
+
+#include <algorithm>
+#include <limits>
+
+PooleSampler::PooleSampler(std::chrono::milliseconds period, std::size_t window, Source source)
+    : m_period(std::max(period, std::chrono::milliseconds(1))), m_source(std::move(source)),
+      m_ring(std::max<std::size_t>(window, 1)) {
+    m_start = std::chrono::steady_clock::now();
+    m_last_time = m_start;
+    m_last_completed = m_source().completed;
+    m_thread = std::thread([this](){ run(); });
+}
+
+PooleSampler::~PooleSampler() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_notifier.notify_all();
+    if (m_thread.joinable()){
+        m_thread.join();
+    }
+}
+
+void PooleSampler::samples(std::vector<PooleSample>& samples) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    samples.clear();
+    std::size_t oldest = (m_next + m_ring.size() - m_size) % m_ring.size();
+    for (std::size_t i = 0; i < m_size; ++i){
+        samples.push_back(m_ring[(oldest + i) % m_ring.size()]);
+    }
+}
+
+std::vector<PooleSample> PooleSampler::samples() const {
+    std::vector<PooleSample> to_return;
+    samples(to_return);
+    return to_return;
+}
+
+void PooleSampler::run() {
+    // Sample on a fixed schedule, a slow sample does not shift the next ones
+    auto next = m_start + m_period;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_notifier.wait_until(lock, next, [this](){ return m_stop; })){
+        lock.unlock();
+        record(std::chrono::steady_clock::now());
+        lock.lock();
+        next += m_period;
+    }
+}
+
+void PooleSampler::record(std::chrono::steady_clock::time_point now) {
+    Counters counters = m_source();
+
+    PooleSample sample;
+    sample.time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_start).count();
+    double seconds = std::chrono::duration<double>(now - m_last_time).count();
+    uint64_t finished = counters.completed - m_last_completed;
+    sample.tasks_per_second = seconds > 0.0 ? static_cast<double>(finished) / seconds : 0.0;
+    sample.pending = counters.pending;
+    sample.running = counters.running;
+    if (counters.pending == 0){
+        sample.wait_ms = 0.0;
+    }else if (sample.tasks_per_second > 0.0){
+        sample.wait_ms = 1000.0 * static_cast<double>(counters.pending) / sample.tasks_per_second;
+    }else{
+        sample.wait_ms = std::numeric_limits<double>::infinity();
+    }
+    m_last_time = now;
+    m_last_completed = counters.completed;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ring[m_next] = sample;
+    m_next = (m_next + 1) % m_ring.size();
+    m_size = std::min(m_size + 1, m_ring.size());
+}
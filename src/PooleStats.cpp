@@ -0,0 +1,263 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+*/
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains the JSON and OpenMetrics exporters of PooleStats
+ *
+ */
+
+#include "PooleStats.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// Appends text to a fixed buffer and keeps counting once it is full, so the
+// caller learns the size it needs
+class BufferWriter {
+ public:
+    BufferWriter(char* buffer, std::size_t size) : m_buffer(buffer), m_size(size), m_length(0) {}
+
+    void text(const char* value) {
+        write(value, std::strlen(value));
+    }
+
+    void number(uint64_t value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        write(digits, static_cast<std::size_t>(result.ptr - digits));
+    }
+
+    void number(double value) {
+        char digits[64];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, 6);
+        write(digits, static_cast<std::size_t>(result.ptr - digits));
+    }
+
+    // Writes the terminator and returns the length of the full text
+    std::size_t finish() {
+        if (m_size > 0){
+            m_buffer[m_length < m_size ? m_length : m_size - 1] = '\0';
+        }
+        return m_length;
+    }
+
+ private:
+    void write(const char* value, std::size_t length) {
+        if (m_length + 1 < m_size){
+            std::size_t room = m_size - 1 - m_length;
+            std::memcpy(m_buffer + m_length, value, length < room ? length : room);
+        }
+        m_length += length;
+    }
+
+    char* m_buffer;
+    std::size_t m_size;
+    std::size_t m_length;
+};
+
+// One OpenMetrics sample line per worker for a ThreadSnapshot field
+template <typename Field>
+void write_worker_metric(BufferWriter& writer, const PooleStats& stats, const char* name,
+        const char* type, const char* unit, const char* help, Field field) {
+    writer.text("# TYPE ");
+    writer.text(name);
+    writer.text(" ");
+    writer.text(type);
+    writer.text("\n");
+    if (unit[0] != '\0'){
+        writer.text("# UNIT ");
+        writer.text(name);
+        writer.text(" ");
+        writer.text(unit);
+        writer.text("\n");
+    }
+    writer.text("# HELP ");
+    writer.text(name);
+    writer.text(" ");
+    writer.text(help);
+    writer.text("\n");
+    for (const auto& worker : stats.workers){
+        writer.text(name);
+        writer.text(std::strcmp(type, "counter") == 0 ? "_total{worker=\"" : "{worker=\"");
+        writer.number(static_cast<uint64_t>(worker.id));
+        writer.text("\"} ");
+        field(writer, worker);
+        writer.text("\n");
+    }
+}
+
+template <typename Value>
+void write_pool_metric(BufferWriter& writer, const char* name, const char* type, const char* help,
+        Value value) {
+    writer.text("# TYPE ");
+    writer.text(name);
+    writer.text(" ");
+    writer.text(type);
+    writer.text("\n# HELP ");
+    writer.text(name);
+    writer.text(" ");
+    writer.text(help);
+    writer.text("\n");
+    writer.text(name);
+    writer.text(std::strcmp(type, "counter") == 0 ? "_total " : " ");
+    writer.number(value);
+    writer.text("\n");
+}
+
+double seconds(uint64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1e9;
+}
+
+}  // namespace
+
+const char* poole_state_name(uint8_t state) {
+    switch (static_cast<ThreadInfo::State>(state)){
+        case ThreadInfo::State::Busy: return "busy";
+        case ThreadInfo::State::Idle: return "idle";
+        case ThreadInfo::State::Parked: return "parked";
+        case ThreadInfo::State::Stopped: return "stopped";
+    }
+    return "unknown";
+}
+
+uint64_t poole_task_time_percentile(const uint64_t* buckets, double quantile) {
+    uint64_t total = 0;
+    for (int i = 0; i < ThreadInfo::kTaskTimeBuckets; ++i){
+        total += buckets[i];
+    }
+    if (total == 0){
+        return 0;
+    }
+
+    // The rank of the wanted task, counted from 1
+    auto rank = static_cast<uint64_t>(quantile * static_cast<double>(total));
+    rank = rank < 1 ? 1 : (rank > total ? total : rank);
+    uint64_t seen = 0;
+    for (int i = 0; i < ThreadInfo::kTaskTimeBuckets; ++i){
+        seen += buckets[i];
+        if (seen >= rank){
+            return uint64_t{1} << (i + 1);
+        }
+    }
+    return uint64_t{1} << ThreadInfo::kTaskTimeBuckets;
+}
+
+std::size_t format_json(const PooleStats& stats, char* buffer, std::size_t size) {
+    BufferWriter writer(buffer, size);
+
+    writer.text("{\"threads\":");
+    writer.number(static_cast<uint64_t>(stats.threads));
+    writer.text(",\"tasks_executed\":");
+    writer.number(stats.tasks_executed);
+    writer.text(",\"tasks_stolen\":");
+    writer.number(stats.tasks_stolen);
+    writer.text(",\"spurious_wakeups\":");
+    writer.number(stats.spurious_wakeups);
+    writer.text(",\"pending\":");
+    writer.number(stats.pending);
+    writer.text(",\"running\":");
+    writer.number(stats.running);
+    writer.text(",\"outstanding\":");
+    writer.number(stats.outstanding);
+    writer.text(",\"peak_pending\":");
+    writer.number(stats.peak_pending);
+    writer.text(",\"task_allocations\":");
+    writer.number(stats.task_allocations);
+    writer.text(",\"task_allocated_bytes\":");
+    writer.number(stats.task_allocated_bytes);
+    writer.text(",\"uptime_ms\":");
+    writer.number(stats.uptime_ms);
+    writer.text(",\"utilization\":");
+    writer.number(stats.utilization);
+    writer.text(",\"workers\":[");
+    for (std::size_t i = 0; i < stats.workers.size(); ++i){
+        const ThreadSnapshot& worker = stats.workers[i];
+        writer.text(i == 0 ? "{\"id\":" : ",{\"id\":");
+        writer.number(static_cast<uint64_t>(worker.id));
+        writer.text(",\"state\":\"");
+        writer.text(poole_state_name(worker.state));
+        writer.text("\",\"tasks\":");
+        writer.number(worker.tasks);
+        writer.text(",\"uptime_ms\":");
+        writer.number(worker.uptime_ms);
+        writer.text(",\"busy_ns\":");
+        writer.number(worker.busy_ns);
+        writer.text(",\"idle_ns\":");
+        writer.number(worker.idle_ns);
+        writer.text(",\"parked_ns\":");
+        writer.number(worker.parked_ns);
+        writer.text(",\"cpu_ns\":");
+        writer.number(worker.cpu_ns);
+        writer.text(",\"utilization\":");
+        writer.number(worker.utilization);
+        writer.text("}");
+    }
+    writer.text("]}");
+
+    return writer.finish();
+}
+
+std::size_t format_openmetrics(const PooleStats& stats, char* buffer, std::size_t size) {
+    BufferWriter writer(buffer, size);
+
+    write_pool_metric(writer, "poole_threads", "gauge", "Worker threads in the pool.",
+            static_cast<uint64_t>(stats.threads));
+    write_pool_metric(writer, "poole_tasks_executed", "counter", "Tasks run to completion.",
+            stats.tasks_executed);
+    write_pool_metric(writer, "poole_tasks_stolen", "counter", "Pinned tasks run by another worker.",
+            stats.tasks_stolen);
+    write_pool_metric(writer, "poole_spurious_wakeups", "counter", "Wake-ups that found no work.",
+            stats.spurious_wakeups);
+    write_pool_metric(writer, "poole_pending_tasks", "gauge", "Tasks submitted but not started.",
+            stats.pending);
+    write_pool_metric(writer, "poole_running_tasks", "gauge", "Tasks running now.",
+            stats.running);
+    write_pool_metric(writer, "poole_outstanding_tasks", "gauge", "Tasks submitted but not finished.",
+            stats.outstanding);
+    write_pool_metric(writer, "poole_peak_pending_tasks", "gauge", "The deepest a queue has been.",
+            stats.peak_pending);
+    write_pool_metric(writer, "poole_task_allocations", "counter", "Closures stored outside their task.",
+            stats.task_allocations);
+    write_pool_metric(writer, "poole_task_allocated_bytes", "counter", "Bytes of closures stored outside their task.",
+            stats.task_allocated_bytes);
+    write_pool_metric(writer, "poole_utilization", "gauge", "Share of worker time spent running tasks.",
+            stats.utilization);
+
+    write_worker_metric(writer, stats, "poole_worker_tasks", "counter", "", "Tasks run by the worker.",
+            [](BufferWriter& out, const ThreadSnapshot& worker){ out.number(worker.tasks); });
+    write_worker_metric(writer, stats, "poole_worker_busy_seconds", "counter", "seconds",
+            "Time the worker spent running tasks.",
+            [](BufferWriter& out, const ThreadSnapshot& worker){ out.number(seconds(worker.busy_ns)); });
+    write_worker_metric(writer, stats, "poole_worker_idle_seconds", "counter", "seconds",
+            "Time the worker spent looking for work.",
+            [](BufferWriter& out, const ThreadSnapshot& worker){ out.number(seconds(worker.idle_ns)); });
+    write_worker_metric(writer, stats, "poole_worker_parked_seconds", "counter", "seconds",
+            "Time the worker spent asleep.",
+            [](BufferWriter& out, const ThreadSnapshot& worker){ out.number(seconds(worker.parked_ns)); });
+    write_worker_metric(writer, stats, "poole_worker_cpu_seconds", "counter", "seconds",
+            "CPU time used by the worker thread.",
+            [](BufferWriter& out, const ThreadSnapshot& worker){ out.number(seconds(worker.cpu_ns)); });
+    write_worker_metric(writer, stats, "poole_worker_utilization", "gauge", "",
+            "Share of the worker time spent running tasks.",
+            [](BufferWriter& out, const ThreadSnapshot& worker){ out.number(worker.utilization); });
+    writer.text("# EOF\n");
+
+    return writer.finish();
+}
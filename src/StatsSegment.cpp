@@ -0,0 +1,245 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+*/
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains the implementation of the shared-memory statistics
+ *          segment. Only POSIX systems can map it, elsewhere opening fails.
+ *
+ */
+
+#include "StatsSegment.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define POOLE_HAS_MMAP 1
+#endif
+
+namespace StatsSegment {
+
+// WRITER
+Writer::~Writer() {
+    close();
+}
+
+bool Writer::open(const std::string& path) {
+    close();
+#if defined(POOLE_HAS_MMAP)
+    // Replace any segment left behind, a reader still holding the old file
+    // keeps its mapping but sees no new publications
+    ::unlink(path.c_str());
+    int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (file < 0){
+        return false;
+    }
+    if (::ftruncate(file, sizeof(Layout)) != 0){
+        ::close(file);
+        ::unlink(path.c_str());
+        return false;
+    }
+    void* memory = ::mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    ::close(file);
+    if (memory == MAP_FAILED){
+        ::unlink(path.c_str());
+        return false;
+    }
+
+    // The file starts zeroed, so a reader sees sequence 0 until the first write
+    m_layout = new (memory) Layout();
+    m_layout->version = kVersion;
+    m_layout->layout_size = sizeof(Layout);
+    m_layout->pid = static_cast<uint32_t>(::getpid());
+    m_path = path;
+    // The magic is written last, a reader ignores the segment until then
+    m_layout->magic.store(kMagic, std::memory_order_release);
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void Writer::write(const PooleStats& stats) {
+    if (m_layout == nullptr){
+        return;
+    }
+
+    uint64_t sequence = m_layout->sequence.load(std::memory_order_relaxed);
+    m_layout->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Data& data = m_layout->data;
+    timespec now{};
+    std::timespec_get(&now, TIME_UTC);
+    data.published_ns = static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+    data.publish_count += 1;
+    data.threads = stats.threads;
+    data.worker_count = static_cast<uint32_t>(std::min<std::size_t>(stats.workers.size(), kMaxWorkers));
+    data.tasks_executed = stats.tasks_executed;
+    data.tasks_stolen = stats.tasks_stolen;
+    data.spurious_wakeups = stats.spurious_wakeups;
+    data.pending = stats.pending;
+    data.running = stats.running;
+    data.outstanding = stats.outstanding;
+    data.peak_pending = stats.peak_pending;
+    data.task_allocations = stats.task_allocations;
+    data.task_allocated_bytes = stats.task_allocated_bytes;
+    data.uptime_ms = stats.uptime_ms;
+    std::memcpy(data.task_time_buckets, stats.task_time_buckets, sizeof(data.task_time_buckets));
+    for (uint32_t i = 0; i < data.worker_count; ++i){
+        const ThreadSnapshot& from = stats.workers[i];
+        Worker& to = data.workers[i];
+        to.id = from.id;
+        to.state = from.state;
+        to.tasks = from.tasks;
+        to.busy_ns = from.busy_ns;
+        to.idle_ns = from.idle_ns;
+        to.parked_ns = from.parked_ns;
+        to.cpu_ns = from.cpu_ns;
+    }
+
+    m_layout->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void Writer::close() {
+#if defined(POOLE_HAS_MMAP)
+    if (m_layout != nullptr){
+        ::munmap(m_layout, sizeof(Layout));
+        ::unlink(m_path.c_str());
+        m_layout = nullptr;
+    }
+#endif
+}
+
+// READER
+Reader::~Reader() {
+    close();
+}
+
+bool Reader::open(const std::string& path) {
+    close();
+#if defined(POOLE_HAS_MMAP)
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0){
+        return false;
+    }
+    struct stat status{};
+    if (::fstat(file, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(Layout)){
+        ::close(file);
+        return false;
+    }
+    void* memory = ::mmap(nullptr, sizeof(Layout), PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+    if (memory == MAP_FAILED){
+        return false;
+    }
+
+    auto layout = static_cast<const Layout*>(memory);
+    uint32_t magic = layout->magic.load(std::memory_order_acquire);
+    if (magic != kMagic || layout->version != kVersion || layout->layout_size != sizeof(Layout)){
+        ::munmap(memory, sizeof(Layout));
+        return false;
+    }
+    m_layout = layout;
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+bool Reader::read(Data& data) const {
+    if (m_layout == nullptr){
+        return false;
+    }
+
+    // Retry while the publisher is writing, it only holds the lock briefly
+    for (int attempt = 0; attempt < 1000; ++attempt){
+        uint64_t before = m_layout->sequence.load(std::memory_order_acquire);
+        if (before == 0){
+            return false;
+        }
+        if (before & 1u){
+            std::this_thread::yield();
+            continue;
+        }
+        std::memcpy(&data, &m_layout->data, sizeof(Data));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_layout->sequence.load(std::memory_order_relaxed) == before){
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t Reader::pid() const {
+    return m_layout == nullptr ? 0 : m_layout->pid;
+}
+
+void Reader::close() {
+#if defined(POOLE_HAS_MMAP)
+    if (m_layout != nullptr){
+        ::munmap(const_cast<Layout*>(m_layout), sizeof(Layout));
+        m_layout = nullptr;
+    }
+#endif
+}
+
+// PUBLISHER
+Publisher::Publisher(const std::string& path, std::chrono::milliseconds interval, Sampler sampler)
+    : m_open(false), m_interval(interval), m_sampler(std::move(sampler)) {
+    m_open = m_writer.open(path);
+    if (m_open){
+        m_thread = std::thread([this](){ run(); });
+    }
+}
+
+Publisher::~Publisher() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_notifier.notify_all();
+    if (m_thread.joinable()){
+        m_thread.join();
+    }
+}
+
+bool Publisher::is_open() const {
+    return m_open;
+}
+
+void Publisher::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop){
+        lock.unlock();
+        m_sampler(m_stats);
+        m_writer.write(m_stats);
+        lock.lock();
+        m_notifier.wait_for(lock, m_interval, [this](){ return m_stop; });
+    }
+}
+
+}  // namespace StatsSegment
@@ -0,0 +1,184 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+*/
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains the implementation of the TaskNodePool size classes,
+ *          the per-thread caches and the shared batch lists between them
+ *
+ */
+
+#include "TaskNodePool.h"
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace TaskNodePool {
+namespace {
+
+struct Node {
+    Node* next;
+};
+
+// A list of nodes moved as a whole between a cache and the shared lists
+struct Batch {
+    Node* head;
+    uint32_t count;
+};
+
+// The nodes of one size class not held by any thread
+struct SharedList {
+    std::mutex mutex;
+    std::vector<Batch> batches;
+};
+
+std::atomic<uint64_t> g_fresh_nodes{0};
+std::atomic<uint64_t> g_released_nodes{0};
+
+// Never destroyed, threads may still return nodes while statics are torn down
+SharedList* shared_lists() {
+    static SharedList* lists = new SharedList[kClassCount];
+    return lists;
+}
+
+std::size_t class_of(std::size_t bytes) {
+    std::size_t size_class = 0;
+    for (std::size_t size = kMinNode; size < bytes; size *= 2){
+        ++size_class;
+    }
+    return size_class;
+}
+
+std::size_t class_size(std::size_t size_class) {
+    return kMinNode << size_class;
+}
+
+// The nodes a thread freed or took, handed back when the thread exits
+struct Cache {
+    ~Cache() {
+        for (std::size_t i = 0; i < kClassCount; ++i){
+            if (count[i] > 0){
+                give(i, Batch{head[i], count[i]});
+                head[i] = nullptr;
+                count[i] = 0;
+            }
+        }
+    }
+
+    void give(std::size_t size_class, Batch batch) {
+        SharedList& list = shared_lists()[size_class];
+        {
+            std::lock_guard<std::mutex> lock(list.mutex);
+            if (list.batches.size() < kMaxSharedBatches){
+                list.batches.push_back(batch);
+                return;
+            }
+        }
+
+        // Enough is kept for the next burst, the rest is freed outside the lock
+        while (batch.head != nullptr){
+            Node* next = batch.head->next;
+            ::operator delete(batch.head);
+            batch.head = next;
+        }
+        g_released_nodes.fetch_add(batch.count, std::memory_order_relaxed);
+    }
+
+    bool take(std::size_t size_class) {
+        SharedList& list = shared_lists()[size_class];
+        std::lock_guard<std::mutex> lock(list.mutex);
+        if (list.batches.empty()){
+            return false;
+        }
+        head[size_class] = list.batches.back().head;
+        count[size_class] = list.batches.back().count;
+        list.batches.pop_back();
+        return true;
+    }
+
+    Node* head[kClassCount] = {};
+    uint32_t count[kClassCount] = {};
+};
+
+thread_local Cache t_cache;
+
+}  // namespace
+
+void* allocate(std::size_t bytes) {
+    if (bytes > kMaxNode){
+        g_fresh_nodes.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(bytes);
+    }
+
+    std::size_t size_class = class_of(bytes);
+    Cache& cache = t_cache;
+    if (cache.count[size_class] == 0 && !cache.take(size_class)){
+        g_fresh_nodes.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(class_size(size_class));
+    }
+
+    Node* node = cache.head[size_class];
+    cache.head[size_class] = node->next;
+    cache.count[size_class] -= 1;
+    return node;
+}
+
+void deallocate(void* memory, std::size_t bytes) noexcept {
+    if (bytes > kMaxNode){
+        ::operator delete(memory);
+        return;
+    }
+
+    std::size_t size_class = class_of(bytes);
+    Cache& cache = t_cache;
+    Node* node = static_cast<Node*>(memory);
+    node->next = cache.head[size_class];
+    cache.head[size_class] = node;
+    cache.count[size_class] += 1;
+
+    // A worker only ever frees, so pass a full batch on to the submitters
+    if (cache.count[size_class] >= 2 * kBatch){
+        Node* first = cache.head[size_class];
+        Node* last = first;
+        for (uint32_t i = 1; i < kBatch; ++i){
+            last = last->next;
+        }
+        cache.head[size_class] = last->next;
+        cache.count[size_class] -= kBatch;
+        last->next = nullptr;
+        try {
+            cache.give(size_class, Batch{first, kBatch});
+        } catch (...) {
+            // Out of memory for the list itself, keep the nodes in the cache
+            last->next = cache.head[size_class];
+            cache.head[size_class] = first;
+            cache.count[size_class] += kBatch;
+        }
+    }
+}
+
+uint64_t fresh_nodes() {
+    return g_fresh_nodes.load(std::memory_order_relaxed);
+}
+
+uint64_t released_nodes() {
+    return g_released_nodes.load(std::memory_order_relaxed);
+}
+
+}  // namespace TaskNodePool
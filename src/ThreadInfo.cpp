@@ -15,7 +15,7 @@
 /**
  * @author: Benrick Smit
  * @date: 20 June 2020
- * @modified: 29 December 2025
+ * @modified: 19 October 2026
  *
  * @brief: This contains the implementations of the ThreadInfo class
  *
@@ -24,9 +24,20 @@
 #include "ThreadInfo.h"  
 
 #include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <time.h>
+#endif
 
 //Constructor
-ThreadInfo::ThreadInfo(){
+ThreadInfo::ThreadInfo()
+    : m_sequence(0), m_state(static_cast<uint8_t>(State::Idle)), m_state_since(0), m_state_time{{0}, {0}, {0}},
+      m_cpu_clock_valid(false), m_cpu_clock(0), m_cpu_time(0) {
+    for (auto& bucket : m_task_time){
+        bucket.store(0, std::memory_order_relaxed);
+    }
     // This function really doesn't have to do much
     set_busy(false);
     set_ID(0);
@@ -47,13 +58,109 @@ bool ThreadInfo::is_done() const {
     return m_thread_is_done;
 }
 
-uint32_t ThreadInfo::get_uptime() const {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - 
+uint64_t ThreadInfo::get_uptime() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - 
             get_start_time()).count();
 }
 
 uint64_t ThreadInfo::get_tasks() const {
-    return m_total_tasks;
+    return m_total_tasks.load(std::memory_order_relaxed);
+}
+
+ThreadInfo::State ThreadInfo::get_state() const {
+    return static_cast<State>(m_state.load(std::memory_order_relaxed));
+}
+
+uint64_t ThreadInfo::get_busy_time() const {
+    return get_state_time(State::Busy);
+}
+
+uint64_t ThreadInfo::get_idle_time() const {
+    return get_state_time(State::Idle);
+}
+
+uint64_t ThreadInfo::get_parked_time() const {
+    return get_state_time(State::Parked);
+}
+
+uint64_t ThreadInfo::get_cpu_time() const {
+#if defined(__linux__)
+    // Read the live clock of a running worker on top of what the earlier
+    // threads of this worker used. Once the worker has exited its clock is
+    // gone and the total it left behind is used instead.
+    if (m_cpu_clock_valid.load()){
+        timespec now{};
+        if (clock_gettime(static_cast<clockid_t>(m_cpu_clock.load()), &now) == 0){
+            uint64_t earlier = m_cpu_time.load();
+            // An exit in between has already added this thread to the total
+            if (m_cpu_clock_valid.load()){
+                return earlier + static_cast<uint64_t>(now.tv_sec) * 1000000000ull
+                        + static_cast<uint64_t>(now.tv_nsec);
+            }
+        }
+    }
+#endif
+    return m_cpu_time.load();
+}
+
+double ThreadInfo::get_utilization() const {
+    // The share of the accounted time that was spent running tasks
+    uint64_t busy = get_busy_time();
+    uint64_t total = busy + get_idle_time() + get_parked_time();
+    if (total == 0){
+        return 0.0;
+    }
+    return static_cast<double>(busy) / static_cast<double>(total);
+}
+
+double ThreadInfo::get_cpu_utilization() const {
+    // The share of the wall-clock time since creation the CPU spent on the thread
+    uint64_t wall = now_ns();
+    if (wall == 0){
+        return 0.0;
+    }
+    return static_cast<double>(get_cpu_time()) / static_cast<double>(wall);
+}
+
+ThreadSnapshot ThreadInfo::snapshot() const {
+    // Read everything the worker updates together under the sequence lock,
+    // retrying when the worker was in the middle of an update
+    ThreadSnapshot to_return;
+    uint64_t since = 0;
+    uint8_t state = 0;
+    uint64_t times[3] = {0, 0, 0};
+    for (;;){
+        uint32_t before = m_sequence.load(std::memory_order_acquire);
+        if (before & 1u){
+            std::this_thread::yield();
+            continue;
+        }
+        to_return.tasks = m_total_tasks.load(std::memory_order_relaxed);
+        state = m_state.load(std::memory_order_relaxed);
+        since = m_state_since.load(std::memory_order_relaxed);
+        for (int i = 0; i < 3; ++i){
+            times[i] = m_state_time[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) == before){
+            break;
+        }
+    }
+
+    uint64_t now = now_ns();
+    if (state < 3 && now > since){
+        times[state] += now - since;
+    }
+    to_return.id = get_ID();
+    to_return.state = state;
+    to_return.uptime_ms = now / 1000000;
+    to_return.busy_ns = times[static_cast<uint8_t>(State::Busy)];
+    to_return.idle_ns = times[static_cast<uint8_t>(State::Idle)];
+    to_return.parked_ns = times[static_cast<uint8_t>(State::Parked)];
+    to_return.cpu_ns = get_cpu_time();
+    uint64_t total = to_return.busy_ns + to_return.idle_ns + to_return.parked_ns;
+    to_return.utilization = total == 0 ? 0.0 : static_cast<double>(to_return.busy_ns) / static_cast<double>(total);
+    return to_return;
 }
 
 
@@ -61,15 +168,59 @@ uint64_t ThreadInfo::get_tasks() const {
 void ThreadInfo::set_busy(bool con) {
     // m_thread_is_done and m_thread_is_finished are mutually exclusive. Setting one, also sets the
     // other.
-    m_thread_is_busy = con;
-    m_thread_is_done = !con;
+    m_thread_is_busy.store(con, std::memory_order_relaxed);
+    m_thread_is_done.store(!con, std::memory_order_relaxed);
 }
 
 void ThreadInfo::set_done(bool con) {
     // m_thread_is_done and m_thread_is_finished are mutually exclusive. Setting one, also sets the
     // other.
-    m_thread_is_done = con;
-    m_thread_is_busy = !con;
+    m_thread_is_done.store(con, std::memory_order_relaxed);
+    m_thread_is_busy.store(!con, std::memory_order_relaxed);
+}
+
+void ThreadInfo::set_state(State state) {
+    // Only the worker itself changes its state, so the time spent in the
+    // previous state can be added without a compare-exchange
+    uint64_t now = now_ns();
+    auto previous = static_cast<State>(m_state.load(std::memory_order_relaxed));
+    begin_update();
+    if (previous != State::Stopped){
+        uint64_t since = m_state_since.load(std::memory_order_relaxed);
+        auto index = static_cast<uint8_t>(previous);
+        m_state_time[index].store(m_state_time[index].load(std::memory_order_relaxed) + (now - since),
+                std::memory_order_relaxed);
+    }
+    if (previous == State::Busy){
+        // The busy interval that just ended is exactly the run time of a task
+        uint64_t run_time = now - m_state_since.load(std::memory_order_relaxed);
+#if defined(__GNUC__) || defined(__clang__)
+        int bucket = run_time < 2 ? 0 : 63 - __builtin_clzll(run_time);
+#else
+        int bucket = 0;
+        while ((run_time >> (bucket + 1)) != 0){
+            ++bucket;
+        }
+#endif
+        bucket = bucket < kTaskTimeBuckets ? bucket : kTaskTimeBuckets - 1;
+        m_task_time[bucket].store(m_task_time[bucket].load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+    }
+    m_state_since.store(now, std::memory_order_relaxed);
+    m_state.store(static_cast<uint8_t>(state), std::memory_order_relaxed);
+    end_update();
+
+    if (state == State::Busy){
+        set_busy(true);
+    }else if (previous == State::Busy){
+        set_done(true);
+    }
+}
+
+void ThreadInfo::add_task_times(uint64_t* buckets) const {
+    for (int i = 0; i < kTaskTimeBuckets; ++i){
+        buckets[i] += m_task_time[i].load(std::memory_order_relaxed);
+    }
 }
 
 void ThreadInfo::set_ID(uint16_t id) {
@@ -80,17 +231,45 @@ void ThreadInfo::set_ID(uint16_t id) {
 void ThreadInfo::add_task(uint32_t total_tasks_to_add) {
     // This function only increments the total number of tasks based on the number, nothing else
     #if defined(__GNUC__) || defined(__clang__)
-    const uint64_t MAX_NUMBER = __UINT32_MAX__;
+    const uint64_t MAX_NUMBER = __UINT64_MAX__;
 #else
-    const uint64_t MAX_NUMBER = UINT32_MAX;
+    const uint64_t MAX_NUMBER = UINT64_MAX;
 #endif
 
     // Check for overflow
+    begin_update();
     if((total_tasks_to_add + get_tasks()) == 0){
         set_tasks(MAX_NUMBER);
     }else{
         set_tasks(get_tasks() + total_tasks_to_add);
     }
+    end_update();
+}
+
+void ThreadInfo::attach_to_current_thread() {
+    // Remember the CPU clock of the calling thread so any thread can read it
+#if defined(__linux__)
+    clockid_t clock;
+    if (pthread_getcpuclockid(pthread_self(), &clock) == 0){
+        m_cpu_clock.store(static_cast<long>(clock));
+        m_cpu_clock_valid.store(true);
+    }
+#endif
+    set_state(State::Idle);
+}
+
+void ThreadInfo::detach_from_current_thread() {
+    // Keep the final CPU time, the clock disappears with the thread. A worker
+    // that was retired and started again adds up the time of every thread.
+#if defined(__linux__)
+    timespec now{};
+    bool measured = clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) == 0;
+    m_cpu_clock_valid.store(false);
+    if (measured){
+        m_cpu_time.fetch_add(static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec));
+    }
+#endif
+    set_state(State::Stopped);
 }
 
 std::string ThreadInfo::to_string() {
@@ -104,18 +283,48 @@ std::string ThreadInfo::to_string() {
     to_return += std::to_string(get_ID());
     to_return += ": " + std::to_string(get_tasks()) + " tasks";
     to_return += "; " + std::to_string(get_uptime()) + " ms";
+    to_return += "; " + std::to_string(static_cast<int>(get_utilization() * 100.0)) + "% busy";
 
     return to_return;
 }
 
-std::chrono::system_clock::time_point ThreadInfo::get_start_time() const {
+std::chrono::steady_clock::time_point ThreadInfo::get_start_time() const {
     return m_start_time_ms;
 }
 
+uint64_t ThreadInfo::get_state_time(State state) const {
+    // Add the part of the current state that has not been accumulated yet
+    auto index = static_cast<uint8_t>(state);
+    uint64_t to_return = m_state_time[index].load(std::memory_order_relaxed);
+    if (m_state.load(std::memory_order_relaxed) == index){
+        uint64_t since = m_state_since.load(std::memory_order_relaxed);
+        uint64_t now = now_ns();
+        if (now > since){
+            to_return += now - since;
+        }
+    }
+    return to_return;
+}
+
+uint64_t ThreadInfo::now_ns() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+            get_start_time()).count();
+}
+
+void ThreadInfo::begin_update() {
+    // Only the worker writes, so a plain increment of the sequence is enough
+    m_sequence.store(m_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void ThreadInfo::end_update() {
+    m_sequence.store(m_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
 void ThreadInfo::set_uptime() {
-    m_start_time_ms = std::chrono::system_clock::now();
+    m_start_time_ms = std::chrono::steady_clock::now();
 }
 
-void ThreadInfo::set_tasks(uint32_t total_tasks) {
-    m_total_tasks = total_tasks;
+void ThreadInfo::set_tasks(uint64_t total_tasks) {
+    m_total_tasks.store(total_tasks, std::memory_order_relaxed);
 }
@@ -0,0 +1,227 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+*/
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains the implementation of the slow-task Watchdog
+ *
+ */
+
+#include "Watchdog.h"
+
+#include <algorithm>
+#include <tuple>
+
+Watchdog::Watchdog(uint32_t total_workers)
+    : m_slot_count(std::max<uint32_t>(total_workers, 1)), m_slots(new Slot[m_slot_count]) {}
+
+Watchdog::~Watchdog() {
+    disable();
+}
+
+void Watchdog::enable(const WatchdogConfig& config) {
+    disable();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_config = config;
+        m_stop = false;
+    }
+    m_run_threshold.store(static_cast<uint64_t>(std::max<int64_t>(config.run_threshold.count(), 0)));
+    m_wait_threshold.store(static_cast<uint64_t>(std::max<int64_t>(config.wait_threshold.count(), 0)));
+    m_enabled.store(true);
+    m_thread = std::thread([this](){ scan(); });
+}
+
+void Watchdog::disable() {
+    m_enabled.store(false);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_notifier.notify_all();
+    if (m_thread.joinable()){
+        m_thread.join();
+    }
+}
+
+uint64_t Watchdog::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Watchdog::task_started(uint32_t worker, const TaskSite& site, uint64_t submit_ns) {
+    Slot& slot = m_slots[worker % m_slot_count];
+    uint64_t now = now_ns();
+    uint64_t wait = (submit_ns != 0 && now > submit_ns) ? now - submit_ns : 0;
+
+    // Publish the site before the start time, the scanner reads them the other way round
+    slot.file.store(site.file, std::memory_order_relaxed);
+    slot.function.store(site.function, std::memory_order_relaxed);
+    slot.label.store(site.label, std::memory_order_relaxed);
+    slot.line.store(site.line, std::memory_order_relaxed);
+    slot.wait_ns.store(wait, std::memory_order_relaxed);
+    slot.flagged.store(false, std::memory_order_relaxed);
+    slot.start_ns.store(now, std::memory_order_release);
+
+    uint64_t threshold = m_wait_threshold.load(std::memory_order_relaxed);
+    if (threshold > 0 && wait > threshold){
+        SlowTask task;
+        task.kind = SlowTask::Kind::SlowWait;
+        task.site = site;
+        task.worker = worker;
+        task.wait_ns = wait;
+        flag(task);
+    }
+}
+
+void Watchdog::task_finished(uint32_t worker) {
+    Slot& slot = m_slots[worker % m_slot_count];
+    uint64_t start = slot.start_ns.load(std::memory_order_relaxed);
+    slot.start_ns.store(0, std::memory_order_release);
+    if (start == 0){
+        return;
+    }
+
+    uint64_t run = now_ns() - start;
+    uint64_t threshold = m_run_threshold.load(std::memory_order_relaxed);
+    if (threshold > 0 && run > threshold){
+        SlowTask task;
+        task.kind = SlowTask::Kind::SlowRun;
+        task.site = read_site(slot);
+        task.worker = worker;
+        task.wait_ns = slot.wait_ns.load(std::memory_order_relaxed);
+        task.run_ns = run;
+        flag(task);
+    }
+}
+
+Watchdog::Suspended Watchdog::suspend(uint32_t worker) const {
+    const Slot& slot = m_slots[worker % m_slot_count];
+    Suspended task;
+    task.start_ns = slot.start_ns.load(std::memory_order_relaxed);
+    task.wait_ns = slot.wait_ns.load(std::memory_order_relaxed);
+    task.site = read_site(slot);
+    task.flagged = slot.flagged.load(std::memory_order_relaxed);
+    return task;
+}
+
+void Watchdog::resume(uint32_t worker, const Suspended& task) {
+    Slot& slot = m_slots[worker % m_slot_count];
+    slot.file.store(task.site.file, std::memory_order_relaxed);
+    slot.function.store(task.site.function, std::memory_order_relaxed);
+    slot.label.store(task.site.label, std::memory_order_relaxed);
+    slot.line.store(task.site.line, std::memory_order_relaxed);
+    slot.wait_ns.store(task.wait_ns, std::memory_order_relaxed);
+    slot.flagged.store(task.flagged, std::memory_order_relaxed);
+    slot.start_ns.store(task.start_ns, std::memory_order_release);
+}
+
+std::vector<CallsiteReport> Watchdog::report() const {
+    std::vector<CallsiteReport> to_return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        to_return.reserve(m_callsites.size());
+        for (const auto& callsite : m_callsites){
+            to_return.push_back(callsite.second);
+        }
+    }
+    return to_return;
+}
+
+void Watchdog::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_callsites.clear();
+}
+
+void Watchdog::scan() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop){
+        std::chrono::milliseconds interval = std::max(m_config.scan_interval, std::chrono::milliseconds(1));
+        if (m_notifier.wait_for(lock, interval, [this](){ return m_stop; })){
+            break;
+        }
+        lock.unlock();
+
+        // Report every task that is over the threshold once, while it still runs
+        uint64_t threshold = m_run_threshold.load(std::memory_order_relaxed);
+        uint64_t now = now_ns();
+        for (uint32_t i = 0; threshold > 0 && i < m_slot_count; ++i){
+            Slot& slot = m_slots[i];
+            uint64_t start = slot.start_ns.load(std::memory_order_acquire);
+            if (start == 0 || now <= start || now - start <= threshold
+                    || slot.flagged.load(std::memory_order_relaxed)){
+                continue;
+            }
+            SlowTask task;
+            task.kind = SlowTask::Kind::StillRunning;
+            task.site = read_site(slot);
+            task.worker = i;
+            task.wait_ns = slot.wait_ns.load(std::memory_order_relaxed);
+            task.run_ns = now - start;
+            // The worker may have moved on while the site was read
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.start_ns.load(std::memory_order_relaxed) != start){
+                continue;
+            }
+            slot.flagged.store(true, std::memory_order_relaxed);
+            flag(task);
+        }
+
+        lock.lock();
+    }
+}
+
+void Watchdog::flag(const SlowTask& task) {
+    std::function<void(const SlowTask&)> callback;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::string key = std::string(task.site.file) + ":" + std::to_string(task.site.line) + " "
+                + task.site.function + " " + (task.site.label != nullptr ? task.site.label : "");
+        CallsiteReport& callsite = m_callsites[key];
+        callsite.site = task.site;
+        switch (task.kind){
+            case SlowTask::Kind::SlowRun:
+                callsite.slow_runs += 1;
+                callsite.total_run_ns += task.run_ns;
+                callsite.max_run_ns = std::max(callsite.max_run_ns, task.run_ns);
+                break;
+            case SlowTask::Kind::SlowWait:
+                callsite.slow_waits += 1;
+                callsite.total_wait_ns += task.wait_ns;
+                callsite.max_wait_ns = std::max(callsite.max_wait_ns, task.wait_ns);
+                break;
+            case SlowTask::Kind::StillRunning:
+                callsite.still_running += 1;
+                break;
+        }
+        callback = m_config.on_slow_task;
+    }
+
+    // Call out without the lock, the callback may well ask for the report
+    if (callback){
+        callback(task);
+    }
+}
+
+TaskSite Watchdog::read_site(const Slot& slot) {
+    TaskSite site;
+    site.file = slot.file.load(std::memory_order_relaxed);
+    site.function = slot.function.load(std::memory_order_relaxed);
+    site.label = slot.label.load(std::memory_order_relaxed);
+    site.line = slot.line.load(std::memory_order_relaxed);
+    return site;
+}
@@ -0,0 +1,110 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+*/
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains the implementation of the per-worker WorkerArena
+ *
+ */
+
+#include "WorkerArena.h"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+
+namespace {
+thread_local WorkerArena* t_current_arena = nullptr;
+}  // namespace
+
+WorkerArena::WorkerArena(std::size_t initial_size)
+    : m_initial_size(std::max<std::size_t>(initial_size, 256)) {}
+
+WorkerArena::~WorkerArena() {
+    release();
+}
+
+std::pmr::memory_resource* WorkerArena::current() {
+    if (t_current_arena != nullptr){
+        return t_current_arena;
+    }
+    return std::pmr::new_delete_resource();
+}
+
+void WorkerArena::set_current(WorkerArena* arena) {
+    t_current_arena = arena;
+}
+
+void* WorkerArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    void* memory = m_cursor;
+    std::size_t space = static_cast<std::size_t>(m_end - m_cursor);
+    if (m_cursor == nullptr || std::align(alignment, bytes, memory, space) == nullptr){
+        // Leave room to align the allocation inside the new chunk
+        grow(bytes + alignment);
+        memory = m_cursor;
+        space = static_cast<std::size_t>(m_end - m_cursor);
+        std::align(alignment, bytes, memory, space);
+    }
+    m_cursor = static_cast<char*>(memory) + bytes;
+    m_used += bytes;
+    return memory;
+}
+
+void WorkerArena::grow(std::size_t minimum) {
+    // Double with every chunk, so a task needs few of them
+    std::size_t size = std::max(m_initial_size, minimum);
+    if (m_chunks != nullptr){
+        size = std::max(size, m_chunks->size * 2);
+    }
+
+    Chunk* chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + size));
+    chunk->next = m_chunks;
+    chunk->size = size;
+    m_chunks = chunk;
+    m_cursor = data(chunk);
+    m_end = m_cursor + size;
+    m_capacity += size;
+}
+
+void WorkerArena::rewind() {
+    m_used = 0;
+    if (m_chunks == nullptr){
+        return;
+    }
+
+    // Merge the chunks of a task that needed more than one into a chunk big
+    // enough for all of them
+    if (m_chunks->next != nullptr){
+        std::size_t total = m_capacity;
+        release();
+        grow(total);
+        return;
+    }
+    m_cursor = data(m_chunks);
+    m_end = m_cursor + m_chunks->size;
+}
+
+void WorkerArena::release() {
+    while (m_chunks != nullptr){
+        Chunk* next = m_chunks->next;
+        ::operator delete(m_chunks);
+        m_chunks = next;
+    }
+    m_cursor = nullptr;
+    m_end = nullptr;
+    m_capacity = 0;
+}
@@ -0,0 +1,167 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+*/
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: This contains the implementation of WorkerThread, the pthread
+ *          attributes and the per-thread settings applied at start-up
+ *
+ */
+
+#include "WorkerThread.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+#if defined(__linux__)
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+namespace {
+
+struct StartArguments {
+    std::function<void()> body;
+    std::string name;
+    std::optional<int> nice;
+    SchedulingPolicy scheduling;
+};
+
+int policy_of(SchedulingPolicy scheduling) {
+    switch (scheduling){
+        case SchedulingPolicy::Batch:
+            return SCHED_BATCH;
+        case SchedulingPolicy::Idle:
+            return SCHED_IDLE;
+        case SchedulingPolicy::Default:
+            break;
+    }
+    return SCHED_OTHER;
+}
+
+void* run_worker(void* argument) {
+    std::unique_ptr<StartArguments> start(static_cast<StartArguments*>(argument));
+
+    // All of these only affect this thread. They are applied from inside it,
+    // some kernels ignore an explicit policy in the creation attributes, and
+    // a refused setting is not worth failing the pool for.
+    pthread_setname_np(pthread_self(), start->name.c_str());
+    if (start->scheduling != SchedulingPolicy::Default){
+        // The batch and idle policies take no priority and need no privileges
+        sched_param parameters{};
+        parameters.sched_priority = 0;
+        pthread_setschedparam(pthread_self(), policy_of(start->scheduling), &parameters);
+    }
+    if (start->nice.has_value()){
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), *start->nice);
+    }
+
+    start->body();
+    return nullptr;
+}
+
+// Creates the thread, with the configured stack size if the system accepts it
+bool create(pthread_t& handle, const WorkerConfig& config, StartArguments* start, bool with_stack) {
+    pthread_attr_t attributes;
+    if (pthread_attr_init(&attributes) != 0){
+        return false;
+    }
+    if (with_stack && config.stack_size > 0){
+        std::size_t stack_size = std::max<std::size_t>(config.stack_size, PTHREAD_STACK_MIN);
+        pthread_attr_setstacksize(&attributes, stack_size);
+    }
+    int result = pthread_create(&handle, &attributes, &run_worker, start);
+    pthread_attr_destroy(&attributes);
+    return result == 0;
+}
+
+}  // namespace
+#endif
+
+WorkerThread::WorkerThread(const WorkerConfig& config, uint32_t id, std::function<void()> body) {
+#if defined(__linux__)
+    auto start = std::make_unique<StartArguments>();
+    start->body = std::move(body);
+    start->name = (config.name_prefix + "-" + std::to_string(id)).substr(0, 15);
+    start->nice = config.nice;
+    start->scheduling = config.scheduling;
+
+    pthread_t handle{};
+    if (create(handle, config, start.get(), true) || create(handle, config, start.get(), false)){
+        start.release();
+        m_handle = handle;
+        m_joinable = true;
+        return;
+    }
+    std::cerr << "ERROR: Poole::WorkerThread() - could not create worker thread " << id << ".";
+    exit(1);
+#else
+    (void)config;
+    (void)id;
+    m_thread = std::thread(std::move(body));
+#endif
+}
+
+WorkerThread::WorkerThread(WorkerThread&& other) noexcept {
+    *this = std::move(other);
+}
+
+WorkerThread& WorkerThread::operator=(WorkerThread&& other) noexcept {
+    if (this != &other){
+        if (joinable()){
+            join();
+        }
+#if defined(__linux__)
+        m_handle = other.m_handle;
+        m_joinable = other.m_joinable;
+        other.m_joinable = false;
+#else
+        m_thread = std::move(other.m_thread);
+#endif
+    }
+    return *this;
+}
+
+WorkerThread::~WorkerThread() {
+    if (joinable()){
+        join();
+    }
+}
+
+bool WorkerThread::joinable() const {
+#if defined(__linux__)
+    return m_joinable;
+#else
+    return m_thread.joinable();
+#endif
+}
+
+void WorkerThread::join() {
+#if defined(__linux__)
+    pthread_join(m_handle, nullptr);
+    m_joinable = false;
+#else
+    m_thread.join();
+#endif
+}
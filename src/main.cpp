@@ -16,7 +16,7 @@
  * @author: Benrick Smit
  * @email: metatronicprogramming@hotmail.com
  * @date: 20 June 2020
- * @modified: 2 December 2020
+ * @modified: 19 October 2026
  * 
  * @brief: This is the main class which gives some function examples and how to 
  * use them with the Poole class to allow for concurrency.
@@ -30,6 +30,7 @@
 #include <ctime>
 #include <random>
 #include <list>
+#include <mutex>
 #include <set>
 
 #include "Poole.h"
@@ -45,6 +46,29 @@ int main(){
 	
 	std::list<uint64_t> prime_list;
 	std::list<uint64_t> prime_brute_list;
+	std::mutex prime_brute_mutex;
+
+	// Pulls the numbers to check one at a time, each task checks its number
+	// on its own and only locks to record a prime in the shared list
+	auto check_primes = [&](Poole& thread_pool){
+		prime_brute_list.clear();
+		int32_t next = 0;
+		thread_pool.add_source([&](Poole::task_type& task){
+			if (next == TOTAL_NUMBERS){
+				return false;
+			}
+			task = [i = next++, &prime_brute_list, &prime_brute_mutex](){
+				std::list<uint64_t> found;
+				if (is_prime_brute_force(i, found)){
+					std::lock_guard<std::mutex> lock(prime_brute_mutex);
+					prime_brute_list.splice(prime_brute_list.end(), found);
+				}
+			};
+			return true;
+		});
+		thread_pool.wait();
+	};
+
 	/*
 	int number = 65;
 
@@ -68,12 +92,7 @@ int main(){
 	std::cout << std::endl;
 	std::cout << "thread_pool1 Statistics:" << std::endl;
 	std::cout << "========================" << std::endl;
-	for(auto i = 0; i < TOTAL_NUMBERS; i++){
-		thread_pool1.add_function([i, prime_brute_list]() mutable {
-			is_prime_brute_force(i, prime_brute_list);
-		});
-	}
-	thread_pool1.wait();
+	check_primes(thread_pool1);
 	std::cout << thread_pool1.statistics() << std::endl;
 
 	// Execution of the 1st 100000 prime numbers with as many as possible threads
@@ -83,12 +102,7 @@ int main(){
 	std::cout << std::endl;
 	std::cout << "thread_pool2 Statistics:" << std::endl;
 	std::cout << "========================" << std::endl;
-	for(auto i = 0; i < TOTAL_NUMBERS; i++){
-		thread_pool2.add_function([i, prime_brute_list]() mutable {
-			is_prime_brute_force(i, prime_brute_list);
-		});
-	}
-	thread_pool2.wait();
+	check_primes(thread_pool2);
 	std::cout << thread_pool2.statistics() << std::endl;
 
 	
@@ -99,12 +113,7 @@ int main(){
 	std::cout << std::endl;
 	std::cout << "thread_pool2 Statistics:" << std::endl;
 	std::cout << "========================" << std::endl;
-	for(auto i = 0; i < TOTAL_NUMBERS; i++){
-		thread_pool3.add_function([i, prime_brute_list]() mutable {
-			is_prime_brute_force(i, prime_brute_list);
-		});
-	}
-	thread_pool3.wait();
+	check_primes(thread_pool3);
 	std::cout << thread_pool3.statistics() << std::endl;
 
 	
@@ -0,0 +1,193 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "Poole.h"
+
+namespace {
+// A fake /proc and /sys below a temporary directory, removed again at the end
+class FakeRoot {
+ public:
+  explicit FakeRoot(const std::string& name)
+      : m_path(std::filesystem::temp_directory_path() / ("poole_cpu_budget_" + name)) {
+    std::filesystem::remove_all(m_path);
+  }
+  ~FakeRoot() { std::filesystem::remove_all(m_path); }
+
+  void write(const std::string& file, const std::string& content) const {
+    std::filesystem::path path = m_path / file;
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream(path) << content;
+  }
+
+  std::string path() const { return m_path.string(); }
+
+ private:
+  std::filesystem::path m_path;
+};
+
+std::string cpu_stat(uint64_t periods, uint64_t throttled) {
+  return "usage_usec 1000\nnr_periods " + std::to_string(periods) + "\nnr_throttled " +
+         std::to_string(throttled) + "\nthrottled_usec " + std::to_string(throttled * 100) + "\n";
+}
+}  // namespace
+
+// CPU BUDGET
+TEST(TEST_CPU_BUDGET_SUITE, Quota_ReadsCgroupV2_PASS) {
+  FakeRoot root("v2");
+  root.write("proc/self/cgroup", "0::/app/worker\n");
+  root.write("sys/fs/cgroup/app/cpu.max", "150000 100000\n");
+  root.write("sys/fs/cgroup/app/worker/cpu.max", "max 100000\n");
+
+  // The parent's limit holds for the child
+  CpuBudget budget(root.path());
+  ASSERT_TRUE(budget.quota().has_value());
+  EXPECT_DOUBLE_EQ(1.5, *budget.quota());
+  uint32_t expected = std::min(2u, std::max(1u, std::thread::hardware_concurrency()));
+  if (budget.affinity() > 0) {
+    expected = std::min(expected, budget.affinity());
+  }
+  EXPECT_EQ(expected, budget.threads());
+}
+
+TEST(TEST_CPU_BUDGET_SUITE, Quota_ReadsCgroupV1_PASS) {
+  FakeRoot root("v1");
+  root.write("proc/self/cgroup", "5:memory:/docker/abc\n4:cpu,cpuacct:/docker/abc\n");
+  root.write("sys/fs/cgroup/cpu,cpuacct/docker/abc/cpu.cfs_quota_us", "400000\n");
+  root.write("sys/fs/cgroup/cpu,cpuacct/docker/abc/cpu.cfs_period_us", "100000\n");
+
+  CpuBudget budget(root.path());
+  ASSERT_TRUE(budget.quota().has_value());
+  EXPECT_DOUBLE_EQ(4.0, *budget.quota());
+}
+
+TEST(TEST_CPU_BUDGET_SUITE, Quota_UnlimitedOrMissing_FAIL) {
+  FakeRoot unlimited("unlimited");
+  unlimited.write("proc/self/cgroup", "0::/\n");
+  unlimited.write("sys/fs/cgroup/cpu.max", "max 100000\n");
+  FakeRoot missing("missing");
+
+  EXPECT_FALSE(CpuBudget(unlimited.path()).quota().has_value());
+  EXPECT_FALSE(CpuBudget(missing.path()).quota().has_value());
+  EXPECT_FALSE(CpuBudget(missing.path()).throttle().has_value());
+  EXPECT_GE(CpuBudget(missing.path()).threads(), 1u);
+}
+
+TEST(TEST_CPU_BUDGET_SUITE, Throttle_ReadsCpuStat_PASS) {
+  FakeRoot root("stat");
+  root.write("proc/self/cgroup", "0::/app\n");
+  root.write("sys/fs/cgroup/app/cpu.stat", cpu_stat(200, 30));
+
+  auto throttle = CpuBudget(root.path()).throttle();
+  ASSERT_TRUE(throttle.has_value());
+  EXPECT_EQ(200u, throttle->periods);
+  EXPECT_EQ(30u, throttle->throttled_periods);
+  EXPECT_EQ(3000000u, throttle->throttled_ns);
+}
+
+TEST(TEST_CPU_BUDGET_SUITE, Default_NeverExceedsHardware_PASS) {
+  Poole thread_pool;
+
+  EXPECT_EQ(CpuBudget::default_threads(), thread_pool.get_possible_threads());
+  EXPECT_LE(thread_pool.get_possible_threads(), std::max(1u, std::thread::hardware_concurrency()));
+}
+
+// THROTTLE WATCH
+TEST(TEST_CPU_BUDGET_SUITE, ThrottleWatch_ShrinksAndGrows_PASS) {
+  FakeRoot root("watch");
+  root.write("proc/self/cgroup", "0::/app\n");
+  root.write("sys/fs/cgroup/app/cpu.stat", cpu_stat(100, 0));
+
+  std::atomic<uint32_t> applied{0};
+  // Polled by hand, the interval is never reached
+  ThrottleWatch watch(CpuBudget(root.path()), 4, std::chrono::hours(1),
+      [&applied](uint32_t threads) { applied = threads; });
+  EXPECT_EQ(4u, watch.threads());
+
+  // Half of the periods since the last poll were throttled
+  root.write("sys/fs/cgroup/app/cpu.stat", cpu_stat(200, 50));
+  EXPECT_EQ(3u, watch.poll());
+  EXPECT_EQ(3u, applied.load());
+  root.write("sys/fs/cgroup/app/cpu.stat", cpu_stat(300, 100));
+  EXPECT_EQ(2u, watch.poll());
+
+  // Quiet periods give the workers back one at a time
+  uint64_t periods = 300;
+  for (uint32_t i = 0; i < ThrottleWatch::kCalmPolls; ++i) {
+    periods += 100;
+    root.write("sys/fs/cgroup/app/cpu.stat", cpu_stat(periods, 100));
+    watch.poll();
+  }
+  EXPECT_EQ(3u, watch.threads());
+  EXPECT_EQ(3u, applied.load());
+}
+
+TEST(TEST_CPU_BUDGET_SUITE, ActiveThreads_InactiveWorkersOnlyRunPinnedTasks_PASS) {
+  std::atomic<uint32_t> wrong_worker{0};
+  std::atomic<uint32_t> executed{0};
+
+  // Only the pinned task is labelled, every other task must run on worker 0
+  WorkerConfig config;
+  config.hooks.before_task = [&wrong_worker](uint32_t worker_id, const TaskSite& site) {
+    if (worker_id != 0 && site.label == nullptr) {
+      wrong_worker++;
+    }
+  };
+  Poole thread_pool{4, config};
+  thread_pool.set_active_threads(1);
+  EXPECT_EQ(1u, thread_pool.get_active_threads());
+
+  for (int i = 0; i < 200; ++i) {
+    thread_pool.add_function([&executed]() { executed++; });
+  }
+  thread_pool.add_function_on(thread_pool.get_possible_threads() - 1, [&executed]() { executed++; },
+      TaskSite::labelled("pinned"));
+  thread_pool.wait();
+
+  EXPECT_EQ(201u, executed.load());
+  EXPECT_EQ(0u, wrong_worker.load());
+
+  thread_pool.set_active_threads(100);
+  EXPECT_EQ(thread_pool.get_possible_threads(), thread_pool.get_active_threads());
+}
+
+// Test case: Watching starts from and returns to the active workers the user set
+TEST(TEST_CPU_BUDGET_SUITE, WatchCpuThrottling_RestoresActiveThreads_PASS) {
+  FakeRoot root("pool_watch");
+  root.write("proc/self/cgroup", "0::/app\n");
+  root.write("sys/fs/cgroup/app/cpu.stat", cpu_stat(100, 0));
+
+  WorkerConfig config;
+  config.allow_oversubscription = true;
+  Poole thread_pool{4, config};
+  thread_pool.set_active_threads(3);
+
+  // An idle watch leaves the count alone
+  ASSERT_TRUE(thread_pool.watch_cpu_throttling(std::chrono::milliseconds(1), CpuBudget(root.path())));
+  thread_pool.stop_watching_cpu_throttling();
+  EXPECT_EQ(3u, thread_pool.get_active_threads());
+
+  // A throttled one lowers it until stopped
+  ASSERT_TRUE(thread_pool.watch_cpu_throttling(std::chrono::milliseconds(1), CpuBudget(root.path())));
+  uint64_t periods = 100;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (thread_pool.get_active_threads() == 3 && std::chrono::steady_clock::now() < deadline) {
+    periods += 100;
+    root.write("sys/fs/cgroup/app/cpu.stat", cpu_stat(periods, periods - 100));
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  EXPECT_LT(thread_pool.get_active_threads(), 3u);
+  thread_pool.stop_watching_cpu_throttling();
+  EXPECT_EQ(3u, thread_pool.get_active_threads());
+}
+
+TEST(TEST_CPU_BUDGET_SUITE, WatchCpuThrottling_WithoutCounters_FAIL) {
+  FakeRoot missing("pool_missing");
+  Poole thread_pool;
+
+  EXPECT_FALSE(thread_pool.watch_cpu_throttling(std::chrono::milliseconds(10), CpuBudget(missing.path())));
+}
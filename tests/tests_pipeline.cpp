@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "Poole.h"
+
+namespace {
+struct Record {
+  uint64_t index = 0;
+  std::string text;
+  uint64_t value = 0;
+};
+
+// Keeps the larger of the two in peak
+void raise_peak(std::atomic<uint32_t>& peak, uint32_t value) {
+  uint32_t seen = peak.load();
+  while (value > seen && !peak.compare_exchange_weak(seen, value)) {
+  }
+}
+
+// Appends to a vector and counts the input as no longer in flight
+class Counted {
+ public:
+  using iterator_category = std::output_iterator_tag;
+  using value_type = void;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = void;
+
+  Counted(std::vector<int>& output, std::atomic<uint32_t>& in_flight) : m_output(&output), m_in_flight(&in_flight) {}
+
+  Counted& operator*() { return *this; }
+  Counted& operator++() { return *this; }
+  Counted& operator=(int value) {
+    m_output->push_back(value);
+    (*m_in_flight)--;
+    return *this;
+  }
+
+ private:
+  std::vector<int>* m_output;
+  std::atomic<uint32_t>* m_in_flight;
+};
+
+// Counts how often a result is move constructed, i.e. stored on its way out
+struct Tracked {
+  static inline std::atomic<uint32_t> moved{0};
+
+  Tracked() = default;
+  explicit Tracked(int v) : value(v) {}
+  Tracked(Tracked&& other) noexcept : value(other.value) { moved++; }
+  Tracked& operator=(Tracked&& other) noexcept {
+    value = other.value;
+    return *this;
+  }
+
+  int value = 0;
+};
+}  // namespace
+
+// PIPELINE
+TEST(TEST_PIPELINE_SUITE, InOrderStage_KeepsSourceOrder_PASS) {
+  Poole thread_pool;
+  uint64_t next = 0;
+  std::vector<uint64_t> written;
+
+  BasicPipeline<Poole, Record> pipeline(thread_pool, 8);
+  pipeline
+      .source([&next](Record& record) {
+        if (next == 5000) {
+          return false;
+        }
+        record.index = next++;
+        record.text = std::to_string(record.index);
+        return true;
+      })
+      .stage(StageMode::parallel, [](Record& record) { record.value = std::stoull(record.text) * 3; })
+      .stage(StageMode::serial_in_order, [&written](Record& record) { written.push_back(record.value); });
+
+  EXPECT_EQ(5000u, pipeline.run());
+  ASSERT_EQ(5000u, written.size());
+  for (uint64_t i = 0; i < written.size(); ++i) {
+    ASSERT_EQ(i * 3, written[i]);
+  }
+}
+
+// Test case: A slow last stage holds the source back
+TEST(TEST_PIPELINE_SUITE, MaxTokens_BoundsItemsInFlight_PASS) {
+  Poole thread_pool;
+  std::atomic<uint32_t> in_flight{0};
+  std::atomic<uint32_t> peak{0};
+  uint64_t next = 0;
+
+  BasicPipeline<Poole, Record> pipeline(thread_pool, 4);
+  pipeline
+      .source([&](Record& record) {
+        if (next == 200) {
+          return false;
+        }
+        record.index = next++;
+        raise_peak(peak, ++in_flight);
+        return true;
+      })
+      .stage(StageMode::parallel, [](Record& record) { record.value = record.index + 1; })
+      .stage(StageMode::serial_in_order, [&in_flight](Record&) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        in_flight--;
+      });
+
+  EXPECT_EQ(200u, pipeline.run());
+  EXPECT_EQ(0u, in_flight.load());
+  EXPECT_LE(peak.load(), 4u);
+}
+
+TEST(TEST_PIPELINE_SUITE, OutOfOrderStage_RunsOneItemAtATime_PASS) {
+  Poole thread_pool;
+  std::atomic<uint32_t> running{0};
+  std::atomic<uint32_t> peak{0};
+  uint64_t next = 0;
+  uint64_t sum = 0;
+
+  BasicPipeline<Poole, Record> pipeline(thread_pool, 16);
+  pipeline
+      .source([&next](Record& record) {
+        if (next == 1000) {
+          return false;
+        }
+        record.index = next++;
+        return true;
+      })
+      .stage(StageMode::serial_out_of_order, [&](Record& record) {
+        raise_peak(peak, ++running);
+        sum += record.index;
+        running--;
+      });
+
+  EXPECT_EQ(1000u, pipeline.run());
+  EXPECT_EQ(1u, peak.load());
+  EXPECT_EQ(999u * 1000u / 2u, sum);
+}
+
+TEST(TEST_PIPELINE_SUITE, Run_RepeatedAndEmptySource_PASS) {
+  Poole thread_pool;
+  uint64_t remaining = 0;
+  std::atomic<uint64_t> seen{0};
+
+  BasicPipeline<Poole, Record> pipeline(thread_pool, 3);
+  pipeline
+      .source([&remaining](Record&) {
+        if (remaining == 0) {
+          return false;
+        }
+        remaining--;
+        return true;
+      })
+      .stage(StageMode::parallel, [&seen](Record&) { seen++; });
+
+  EXPECT_EQ(0u, pipeline.run());
+  remaining = 10;
+  EXPECT_EQ(10u, pipeline.run());
+  remaining = 7;
+  EXPECT_EQ(7u, pipeline.run());
+  EXPECT_EQ(17u, seen.load());
+}
+
+// Test case: The only worker runs the pipeline, nothing else could run its stages
+TEST(TEST_PIPELINE_SUITE, Run_FromTheOnlyWorker_PASS) {
+  WorkerConfig config;
+  config.blocking_spares = 0;
+  Poole thread_pool{1, config};
+  std::atomic<uint64_t> produced{0};
+  std::vector<uint64_t> written;
+
+  thread_pool.add_function([&]() {
+    uint64_t next = 0;
+    BasicPipeline<Poole, Record> pipeline(thread_pool, 4);
+    pipeline
+        .source([&next](Record& record) {
+          if (next == 500) {
+            return false;
+          }
+          record.index = next++;
+          return true;
+        })
+        .stage(StageMode::parallel, [](Record& record) { record.value = record.index * 2; })
+        .stage(StageMode::serial_in_order, [&written](Record& record) { written.push_back(record.value); });
+    produced = pipeline.run();
+  });
+  thread_pool.wait();
+
+  EXPECT_EQ(500u, produced.load());
+  ASSERT_EQ(500u, written.size());
+  for (uint64_t i = 0; i < written.size(); ++i) {
+    ASSERT_EQ(i * 2, written[i]);
+  }
+}
+
+// PARALLEL MAP
+TEST(TEST_PIPELINE_SUITE, ParallelMapOrdered_KeepsInputOrder_PASS) {
+  Poole thread_pool;
+  std::vector<uint32_t> input(2000);
+  for (uint32_t i = 0; i < input.size(); ++i) {
+    input[i] = i;
+  }
+
+  // Uneven work so that later inputs often finish first
+  std::vector<std::string> output(input.size());
+  auto end = thread_pool.parallel_map_ordered(input.begin(), input.end(), [](const uint32_t& value) {
+    if (value % 7 == 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    return std::to_string(value * 2);
+  }, output.begin(), 16);
+
+  EXPECT_EQ(output.end(), end);
+  for (uint32_t i = 0; i < output.size(); ++i) {
+    ASSERT_EQ(std::to_string(i * 2), output[i]);
+  }
+}
+
+// Test case: A sized output gets every result assigned to its element directly
+TEST(TEST_PIPELINE_SUITE, ParallelMapOrdered_WritesStraightIntoTheOutput_PASS) {
+  Poole thread_pool;
+  std::vector<int> input(500);
+  for (int i = 0; i < static_cast<int>(input.size()); ++i) {
+    input[i] = i;
+  }
+
+  Tracked::moved = 0;
+  std::vector<Tracked> output(input.size());
+  auto end = thread_pool.parallel_map_ordered(input.begin(), input.end(),
+      [](const int& value) { return Tracked(value + 1); }, output.begin(), 8);
+
+  EXPECT_EQ(output.end(), end);
+  EXPECT_EQ(0u, Tracked::moved.load());
+  for (int i = 0; i < static_cast<int>(output.size()); ++i) {
+    ASSERT_EQ(i + 1, output[i].value);
+  }
+}
+
+TEST(TEST_PIPELINE_SUITE, ParallelMapOrdered_WindowBoundsInputsInFlight_PASS) {
+  Poole thread_pool;
+  std::atomic<uint32_t> in_flight{0};
+  std::atomic<uint32_t> peak{0};
+
+  // A single-pass stream, counted from being read until written
+  std::istringstream stream("5 4 3 2 1 0 9 8 7 6 5 4 3 2 1 0 9 8 7 6 5 4 3 2 1");
+  std::vector<int> output;
+  thread_pool.parallel_map_ordered(std::istream_iterator<int>(stream), std::istream_iterator<int>(),
+      [&](const int& value) {
+        raise_peak(peak, ++in_flight);
+        std::this_thread::sleep_for(std::chrono::microseconds(100 * value));
+        return value + 1;
+      },
+      Counted(output, in_flight), 3);
+
+  std::vector<int> expected{6, 5, 4, 3, 2, 1, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 10, 9, 8, 7, 6, 5, 4, 3, 2};
+  EXPECT_EQ(expected, output);
+  EXPECT_LE(peak.load(), 3u);
+}
+
+// Test case: A task maps on its own pool, whose only worker it occupies
+TEST(TEST_PIPELINE_SUITE, ParallelMapOrdered_FromATask_PASS) {
+  WorkerConfig config;
+  config.blocking_spares = 0;
+  Poole thread_pool{1, config};
+  std::vector<int> input{3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
+  std::vector<int> output(input.size());
+
+  thread_pool.add_function([&]() {
+    thread_pool.parallel_map_ordered(input.begin(), input.end(), [](const int& value) { return value * value; },
+        output.begin(), 2);
+  });
+  thread_pool.wait();
+
+  std::vector<int> expected{9, 1, 16, 1, 25, 81, 4, 36, 25, 9, 25};
+  EXPECT_EQ(expected, output);
+}
+
+TEST(TEST_PIPELINE_SUITE, ParallelMapOrdered_EmptyInput_PASS) {
+  Poole thread_pool;
+  std::vector<int> input;
+  std::vector<int> output;
+
+  thread_pool.parallel_map_ordered(input.begin(), input.end(), [](const int& value) { return value; },
+      std::back_inserter(output));
+  EXPECT_TRUE(output.empty());
+}
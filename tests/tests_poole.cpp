@@ -2,6 +2,18 @@
 #include <atomic>
 #include <vector>
 #include <chrono>
+#include <mutex>
+#include <algorithm>
+#include <memory_resource>
+#include <string>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "gtest/gtest.h"
 #include "Poole.h"
@@ -418,4 +430,1056 @@ TEST(TEST_POOLE_SUITE, PauseResume_PauseDuringWait_PASS) {
     wait_thread.join();       // Wait for the wait_thread to finish
 
     EXPECT_EQ(num_tasks, counter.load());
-}
\ No newline at end of file
+}
+// Test case: The default Poole counts every task it executes
+TEST(TEST_POOLE_SUITE, Statistics_TotalTasksExecuted_PASS) {
+    const int num_tasks = 200;
+
+    Poole thread_pool{2};
+    for (int i = 0; i < num_tasks; ++i) {
+        thread_pool.add_function([]() {});
+    }
+    thread_pool.wait();
+
+    EXPECT_EQ(static_cast<uint64_t>(num_tasks), thread_pool.get_total_tasks_executed());
+    EXPECT_FALSE(thread_pool.is_busy());
+    EXPECT_TRUE(thread_pool.is_done());
+}
+
+// Test case: StatsPolicy::None still runs every task but keeps no statistics
+TEST(TEST_POOLE_SUITE, BasicPoole_StatsPolicyNone_PASS) {
+    using LeanPoole = BasicPoole<QueuePolicy::Fifo, IdlePolicy::Futex, StatsPolicy::None,
+        std::function<void()>>;
+    const int num_tasks = 500;
+    std::atomic<int> counter{0};
+
+    LeanPoole thread_pool{2};
+    for (int i = 0; i < num_tasks; ++i) {
+        thread_pool.add_function([&counter]() {
+            counter++;
+        });
+    }
+    thread_pool.wait();
+
+    EXPECT_EQ(num_tasks, counter.load());
+    EXPECT_EQ(0u, thread_pool.get_total_tasks_executed());
+    EXPECT_NE(std::string::npos, thread_pool.statistics().find("disabled"));
+}
+
+// Test case: Workers that spin before sleeping behave like the default pool
+TEST(TEST_POOLE_SUITE, BasicPoole_SpinIdlePolicy_PASS) {
+    using SpinPoole = BasicPoole<QueuePolicy::Fifo, IdlePolicy::Spin<>, StatsPolicy::Full,
+        std::function<void()>>;
+    const int num_tasks = 500;
+    std::atomic<int> counter{0};
+
+    SpinPoole thread_pool{2};
+    thread_pool.pause(true);
+    for (int i = 0; i < num_tasks; ++i) {
+        thread_pool.add_function([&counter]() {
+            counter++;
+        });
+    }
+    EXPECT_EQ(0, counter.load());
+    thread_pool.pause(false);
+    thread_pool.wait();
+
+    EXPECT_EQ(num_tasks, counter.load());
+    EXPECT_EQ(static_cast<uint64_t>(num_tasks), thread_pool.get_total_tasks_executed());
+}
+
+// Test case: Tasks pinned to a worker all run on that worker
+TEST(TEST_POOLE_SUITE, AddFunctionOn_RunsOnChosenWorker_PASS) {
+    const int num_tasks = 100;
+    std::atomic<int> counter{0};
+
+    Poole thread_pool;
+    thread_pool.set_steal_threshold(num_tasks); // Never overloaded, never stolen
+    const uint32_t target = thread_pool.get_possible_threads() - 1;
+
+    for (int i = 0; i < num_tasks; ++i) {
+        thread_pool.add_function_on(target, [&counter]() {
+            counter++;
+        });
+    }
+    thread_pool.wait();
+
+    EXPECT_EQ(num_tasks, counter.load());
+    EXPECT_EQ(static_cast<unsigned long long>(num_tasks),
+        thread_pool.get_thread_total_tasks_executed()[target]);
+    EXPECT_EQ(0u, thread_pool.get_total_tasks_stolen());
+}
+
+// Test case: Tasks submitted with the same key run on the same thread
+TEST(TEST_POOLE_SUITE, AddFunctionKeyed_SameKeySameThread_PASS) {
+    const int num_keys = 8;
+    const int tasks_per_key = 20;
+    std::vector<std::vector<std::thread::id>> seen(num_keys);
+    std::vector<std::mutex> seen_mutex(num_keys);
+
+    Poole thread_pool;
+    thread_pool.set_steal_threshold(num_keys * tasks_per_key);
+
+    for (int i = 0; i < tasks_per_key; ++i) {
+        for (int key = 0; key < num_keys; ++key) {
+            thread_pool.add_function_keyed(key, [&seen, &seen_mutex, key]() {
+                std::lock_guard<std::mutex> lock(seen_mutex[key]);
+                seen[key].push_back(std::this_thread::get_id());
+            });
+        }
+    }
+    thread_pool.wait();
+
+    for (int key = 0; key < num_keys; ++key) {
+        ASSERT_EQ(static_cast<size_t>(tasks_per_key), seen[key].size());
+        for (auto const& id : seen[key]) {
+            EXPECT_EQ(seen[key].front(), id);
+        }
+    }
+}
+
+// Test case: Idle workers steal from a worker once it is overloaded
+TEST(TEST_POOLE_SUITE, AddFunctionOn_OverloadedWorkerIsStolenFrom_PASS) {
+    Poole thread_pool;
+    if (thread_pool.get_possible_threads() < 2) {
+        GTEST_SKIP() << "Stealing needs at least two workers";
+    }
+    const int num_tasks = 10;
+    std::atomic<int> counter{0};
+    std::atomic<bool> release{false};
+
+    thread_pool.set_steal_threshold(1);
+    // The first task occupies worker 0 until the others have run elsewhere,
+    // only the last one is left behind as it no longer overloads the worker
+    thread_pool.add_function_on(0, [&counter, &release, num_tasks]() {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (counter.load() < num_tasks - 1 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        release = true;
+    });
+    for (int i = 0; i < num_tasks; ++i) {
+        thread_pool.add_function_on(0, [&counter]() {
+            counter++;
+        });
+    }
+    thread_pool.wait();
+
+    EXPECT_EQ(num_tasks, counter.load());
+    EXPECT_TRUE(release.load());
+    EXPECT_GT(thread_pool.get_total_tasks_stolen(), 0u);
+}
+
+// Test case: A strand runs its tasks one at a time and in submission order
+TEST(TEST_POOLE_SUITE, Strand_RunsInSubmissionOrder_PASS) {
+    const int num_tasks = 1000;
+    std::vector<int> order;
+    std::atomic<int> in_flight{0};
+    std::atomic<int> overlaps{0};
+
+    Poole thread_pool;
+    auto strand = thread_pool.make_strand();
+    for (int i = 0; i < num_tasks; ++i) {
+        strand.add_function([&order, &in_flight, &overlaps, i]() {
+            if (in_flight.fetch_add(1) != 0) {
+                overlaps++;
+            }
+            order.push_back(i); // Safe without a lock, the strand is serial
+            in_flight.fetch_sub(1);
+        });
+    }
+    thread_pool.wait();
+
+    ASSERT_EQ(static_cast<size_t>(num_tasks), order.size());
+    for (int i = 0; i < num_tasks; ++i) {
+        EXPECT_EQ(i, order[i]);
+    }
+    EXPECT_EQ(0, overlaps.load());
+}
+
+// Test case: Several producers on several strands, every producer keeps its order
+TEST(TEST_POOLE_SUITE, Strand_ConcurrentProducersKeepOrder_PASS) {
+    const int num_strands = 4;
+    const int tasks_per_strand = 500;
+    std::vector<std::vector<int>> results(num_strands);
+
+    Poole thread_pool;
+    std::vector<BasicStrand<Poole>> strands;
+    for (int s = 0; s < num_strands; ++s) {
+        strands.push_back(thread_pool.make_strand());
+    }
+
+    std::vector<std::thread> producers;
+    for (int s = 0; s < num_strands; ++s) {
+        producers.emplace_back([&strands, &results, s, tasks_per_strand]() {
+            for (int i = 0; i < tasks_per_strand; ++i) {
+                strands[s].add_function([&results, s, i]() {
+                    results[s].push_back(i);
+                });
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    thread_pool.wait();
+
+    for (int s = 0; s < num_strands; ++s) {
+        ASSERT_EQ(static_cast<size_t>(tasks_per_strand), results[s].size());
+        for (int i = 0; i < tasks_per_strand; ++i) {
+            EXPECT_EQ(i, results[s][i]);
+        }
+    }
+}
+
+// Test case: Every strand task reaches the hooks under its own site
+TEST(TEST_POOLE_SUITE, Strand_ReportsEveryTaskUnderItsSite_PASS) {
+    std::atomic<uint32_t> first{0};
+    std::atomic<uint32_t> second{0};
+    std::atomic<uint32_t> other{0};
+
+    WorkerConfig config;
+    config.hooks.before_task = [&](uint32_t, const TaskSite& site) {
+        if (site.label != nullptr && std::string(site.label) == "first") {
+            first++;
+        } else if (site.label != nullptr && std::string(site.label) == "second") {
+            second++;
+        } else {
+            other++;
+        }
+    };
+    Poole thread_pool{2, config};
+    auto strand = thread_pool.make_strand();
+
+    // Queued behind one another, so all of them drain in one relay task
+    thread_pool.pause(true);
+    for (int i = 0; i < 200; ++i) {
+        strand.add_function([]() {}, TaskSite::labelled(i % 2 == 0 ? "first" : "second"));
+    }
+    thread_pool.pause(false);
+    thread_pool.wait();
+
+    EXPECT_EQ(100u, first.load());
+    EXPECT_EQ(100u, second.load());
+    EXPECT_EQ(0u, other.load());
+}
+
+// Test case: The tasks waiting in a strand are pending tasks of the pool
+TEST(TEST_POOLE_SUITE, Strand_BacklogCountsAsPending_PASS) {
+    std::atomic<uint32_t> executed{0};
+
+    Poole thread_pool{2};
+    auto strand = thread_pool.make_strand();
+    thread_pool.pause(true);
+    for (int i = 0; i < 50; ++i) {
+        strand.add_function([&executed]() { executed++; });
+    }
+    EXPECT_EQ(50u, thread_pool.get_pending_tasks());
+    EXPECT_EQ(50u, thread_pool.snapshot().outstanding);
+
+    thread_pool.pause(false);
+    thread_pool.wait();
+    EXPECT_EQ(50u, executed.load());
+    EXPECT_EQ(0u, thread_pool.get_pending_tasks());
+}
+
+TEST(TEST_POOLE_SUITE, BatchDequeue_EveryTaskRunsOnce_PASS) {
+    const int num_tasks = 20000;
+    std::vector<std::atomic<int>> runs(num_tasks);
+
+    Poole thread_pool{4};
+    thread_pool.pause(true);
+    for (int i = 0; i < num_tasks; ++i) {
+        thread_pool.add_function([&runs, i]() {
+            runs[i]++;
+        });
+    }
+    thread_pool.pause(false);
+    thread_pool.wait();
+
+    for (int i = 0; i < num_tasks; ++i) {
+        ASSERT_EQ(1, runs[i].load());
+    }
+    EXPECT_EQ(static_cast<uint64_t>(num_tasks), thread_pool.get_total_tasks_executed());
+}
+
+TEST(TEST_POOLE_SUITE, BatchDequeue_PauseHoldsBufferedTasks_PASS) {
+    const int num_tasks = 1000;
+    std::atomic<int> counter{0};
+    std::atomic<bool> release{false};
+
+    Poole thread_pool{1};
+    thread_pool.set_batch_limit(Poole::kMaxBatch);
+    thread_pool.pause(true);
+    // The first task holds the worker while the rest sit in its batch
+    thread_pool.add_function([&release]() {
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    for (int i = 0; i < num_tasks; ++i) {
+        thread_pool.add_function([&counter]() {
+            counter++;
+        });
+    }
+    thread_pool.pause(false);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    thread_pool.pause(true);
+    release = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    EXPECT_EQ(0, counter.load());
+    EXPECT_TRUE(thread_pool.is_busy());
+
+    thread_pool.wait();
+    EXPECT_EQ(num_tasks, counter.load());
+}
+
+TEST(TEST_POOLE_SUITE, ShardedQueue_AnyWorkerFindsEveryTask_PASS) {
+    const int num_tasks = 100;
+    QueuePolicy::Sharded<4>::type<int> queue{2};
+    for (int i = 0; i < num_tasks; ++i) {
+        int task = i;
+        EXPECT_TRUE(queue.push(std::move(task)));
+    }
+
+    std::vector<int> taken;
+    int task = 0;
+    while (queue.try_pop(task, 1)) {
+        taken.push_back(task);
+    }
+    std::sort(taken.begin(), taken.end());
+    ASSERT_EQ(static_cast<size_t>(num_tasks), taken.size());
+    for (int i = 0; i < num_tasks; ++i) {
+        EXPECT_EQ(i, taken[i]);
+    }
+}
+
+TEST(TEST_POOLE_SUITE, ShardedQueue_ManyProducers_PASS) {
+    using ShardedPoole = BasicPoole<QueuePolicy::Sharded<>, IdlePolicy::Futex, StatsPolicy::Full,
+        std::function<void()>>;
+    const int num_producers = 4;
+    const int tasks_per_producer = 2500;
+    std::atomic<int> counter{0};
+
+    ShardedPoole thread_pool{4};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&thread_pool, &counter, tasks_per_producer]() {
+            for (int i = 0; i < tasks_per_producer; ++i) {
+                thread_pool.add_function([&counter]() {
+                    counter++;
+                });
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    thread_pool.wait();
+
+    EXPECT_EQ(num_producers * tasks_per_producer, counter.load());
+    EXPECT_EQ(static_cast<uint64_t>(num_producers * tasks_per_producer),
+        thread_pool.get_total_tasks_executed());
+}
+
+TEST(TEST_POOLE_SUITE, FutexIdle_TargetedWakeAndSpuriousCount_PASS) {
+    IdlePolicy::Futex idle{2};
+    std::atomic<bool> ready{false};
+    std::atomic<bool> returned{false};
+
+    std::thread sleeper([&]() {
+        idle.park(1, [&ready]() { return ready.load(); });
+        returned = true;
+    });
+    while (idle.sleepers() == 0) {
+        std::this_thread::yield();
+    }
+
+    // Waking the other slot does nothing, waking this one without work is spurious
+    idle.notify(0);
+    idle.notify(1);
+    while (idle.spurious_wakeups() == 0) {
+        std::this_thread::yield();
+    }
+    EXPECT_FALSE(returned.load());
+
+    ready = true;
+    while (!returned.load()) {
+        idle.notify(1);
+        std::this_thread::yield();
+    }
+    sleeper.join();
+    EXPECT_EQ(1u, idle.spurious_wakeups());
+    EXPECT_EQ(0u, idle.sleepers());
+}
+
+TEST(TEST_POOLE_SUITE, Statistics_UtilizationAndCpuTime_PASS) {
+    Poole thread_pool{1};
+
+    // Half of the time busy sleeping, then a burst of real CPU work
+    thread_pool.add_function([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    });
+    thread_pool.wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    thread_pool.add_function([]() {
+        auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+        while (std::chrono::steady_clock::now() < end) {
+        }
+    });
+    thread_pool.wait();
+
+    double utilization = thread_pool.get_thread_utilization()[0];
+    EXPECT_GT(utilization, 0.2);
+    EXPECT_LT(utilization, 0.95);
+    EXPECT_GT(thread_pool.get_total_utilization(), 0.2);
+    EXPECT_GE(thread_pool.get_thread_cpu_time()[0], 5000000u);
+    EXPECT_NE(std::string::npos, thread_pool.statistics().find("% busy"));
+}
+
+TEST(TEST_POOLE_SUITE, Gauges_PendingRunningAndPeak_PASS) {
+    const int num_tasks = 10;
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+
+    Poole thread_pool{1};
+    thread_pool.add_function([&started, &release]() {
+        started = true;
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!started.load()) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < num_tasks; ++i) {
+        thread_pool.add_function([]() {});
+    }
+
+    EXPECT_EQ(1u, thread_pool.get_running_tasks());
+    EXPECT_EQ(static_cast<uint64_t>(num_tasks), thread_pool.get_pending_tasks());
+    EXPECT_EQ(static_cast<uint64_t>(num_tasks), thread_pool.get_peak_pending_tasks());
+
+    release = true;
+    thread_pool.wait();
+    EXPECT_EQ(0u, thread_pool.get_running_tasks());
+    EXPECT_EQ(0u, thread_pool.get_pending_tasks());
+    EXPECT_EQ(static_cast<uint64_t>(num_tasks), thread_pool.reset_peak_pending_tasks());
+    EXPECT_EQ(0u, thread_pool.get_peak_pending_tasks());
+}
+
+TEST(TEST_POOLE_SUITE, WorkerHooks_RunAroundWorkersAndTasks_PASS) {
+    const int num_tasks = 500;
+    static thread_local int worker_slot = -1;
+    std::atomic<int> started{0};
+    std::atomic<int> stopped{0};
+    std::atomic<int> before{0};
+    std::atomic<int> after{0};
+    std::atomic<int> unprepared{0};
+
+    WorkerHooks hooks;
+    hooks.on_worker_start = [&started](uint32_t worker_id) {
+        worker_slot = static_cast<int>(worker_id);
+        started++;
+    };
+    hooks.on_worker_stop = [&stopped](uint32_t) {
+        stopped++;
+    };
+    hooks.before_task = [&before](uint32_t, const TaskSite& site) {
+        if (site.label != nullptr) {
+            before++;
+        }
+    };
+    hooks.after_task = [&after](uint32_t worker_id, const TaskSite&) {
+        if (worker_slot == static_cast<int>(worker_id)) {
+            after++;
+        }
+    };
+
+    uint32_t threads = 0;
+    {
+        Poole thread_pool{4, hooks};
+        threads = thread_pool.get_possible_threads();
+        for (int i = 0; i < num_tasks; ++i) {
+            thread_pool.add_function([&unprepared]() {
+                // The start hook has prepared every worker before its first task
+                if (worker_slot < 0) {
+                    unprepared++;
+                }
+            }, TaskSite::labelled("hooked"));
+        }
+        thread_pool.wait();
+    }
+
+    EXPECT_EQ(static_cast<int>(threads), started.load());
+    EXPECT_EQ(static_cast<int>(threads), stopped.load());
+    EXPECT_EQ(num_tasks, before.load());
+    EXPECT_EQ(num_tasks, after.load());
+    EXPECT_EQ(0, unprepared.load());
+}
+
+TEST(TEST_POOLE_SUITE, WorkerArena_RewoundAfterEveryTask_PASS) {
+    const int num_tasks = 200;
+    std::vector<const void*> addresses(num_tasks, nullptr);
+    std::atomic<int> large_sum{0};
+
+    // Outside a worker the arena falls back to new and delete
+    EXPECT_EQ(std::pmr::new_delete_resource(), Poole::this_worker_arena());
+
+    Poole thread_pool{1};
+    for (int i = 0; i < num_tasks; ++i) {
+        thread_pool.add_function([&addresses, i]() {
+            std::pmr::vector<int> values(Poole::this_worker_arena());
+            values.reserve(100);
+            addresses[i] = values.data();
+        });
+    }
+    // More than the first chunk holds, the arena grows and merges its chunks
+    thread_pool.add_function([&large_sum]() {
+        std::pmr::vector<char> large(WorkerArena::kDefaultSize * 3, 1, Poole::this_worker_arena());
+        large_sum = std::count(large.begin(), large.end(), 1);
+    });
+    thread_pool.wait();
+
+    for (int i = 1; i < num_tasks; ++i) {
+        EXPECT_EQ(addresses[0], addresses[i]);
+    }
+    EXPECT_EQ(static_cast<int>(WorkerArena::kDefaultSize * 3), large_sum.load());
+}
+
+TEST(TEST_POOLE_SUITE, LocalSubmission_WorkerRunsNewestFirst_PASS) {
+    const int num_children = 10;
+    std::mutex order_mutex;
+    std::vector<int> order;
+
+    Poole thread_pool{1};
+    thread_pool.add_function([&thread_pool, &order_mutex, &order]() {
+        for (int i = 0; i < num_children; ++i) {
+            thread_pool.add_function([&order_mutex, &order, i]() {
+                std::lock_guard<std::mutex> lock(order_mutex);
+                order.push_back(i);
+            });
+        }
+    });
+    thread_pool.wait();
+
+    // External submissions stay first in, first out
+    thread_pool.pause(true);
+    for (int i = 0; i < num_children; ++i) {
+        thread_pool.add_function([&order_mutex, &order, i]() {
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(100 + i);
+        });
+    }
+    thread_pool.pause(false);
+    thread_pool.wait();
+
+    ASSERT_EQ(static_cast<size_t>(2 * num_children), order.size());
+    for (int i = 0; i < num_children; ++i) {
+        EXPECT_EQ(num_children - 1 - i, order[i]);
+        EXPECT_EQ(100 + i, order[num_children + i]);
+    }
+}
+
+TEST(TEST_POOLE_SUITE, LocalSubmission_RecursiveSplitIsStolen_PASS) {
+    const uint64_t range = 1 << 16;
+    const uint64_t leaf = 64;
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> leaves{0};
+
+    Poole thread_pool{4};
+    std::function<void(uint64_t, uint64_t)> split = [&](uint64_t begin, uint64_t end) {
+        if (end - begin <= leaf) {
+            uint64_t partial = 0;
+            for (uint64_t i = begin; i < end; ++i) {
+                partial += i;
+            }
+            sum += partial;
+            leaves++;
+            // Give the CPU away, so sleeping workers get to steal even on one core
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+            return;
+        }
+        uint64_t middle = begin + (end - begin) / 2;
+        thread_pool.add_function([&split, begin, middle]() { split(begin, middle); });
+        thread_pool.add_function([&split, middle, end]() { split(middle, end); });
+    };
+    thread_pool.add_function([&split, range]() { split(0, range); });
+    thread_pool.wait();
+
+    EXPECT_EQ(range * (range - 1) / 2, sum.load());
+    EXPECT_EQ(range / leaf, leaves.load());
+    if (thread_pool.get_possible_threads() > 1) {
+        EXPECT_GT(thread_pool.get_total_tasks_stolen(), 0u);
+    }
+}
+
+TEST(TEST_POOLE_SUITE, LocalSubmission_FullDequeSpillsToSharedQueue_PASS) {
+    const int num_children = 3 * Poole::kLocalCapacity;
+    std::atomic<int> counter{0};
+
+    Poole thread_pool{2};
+    thread_pool.add_function([&thread_pool, &counter]() {
+        for (int i = 0; i < num_children; ++i) {
+            EXPECT_TRUE(thread_pool.try_add_function([&counter]() {
+                counter++;
+            }));
+        }
+    });
+    thread_pool.wait();
+
+    EXPECT_EQ(num_children, counter.load());
+}
+
+#if defined(__linux__)
+TEST(TEST_POOLE_SUITE, WorkerConfig_AppliesThreadAttributes_PASS) {
+    const size_t stack_size = 256 * 1024;
+    std::mutex mutex;
+    std::vector<std::string> names;
+    size_t worker_stack = 0;
+    int worker_nice = 0;
+    int worker_policy = -1;
+
+    WorkerConfig config;
+    config.name_prefix = "attr-test";
+    config.stack_size = stack_size;
+    config.nice = 5;
+    config.scheduling = SchedulingPolicy::Batch;
+
+    Poole thread_pool{1, config};
+    thread_pool.add_function([&]() {
+        char name[16] = {};
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        pthread_attr_t attributes;
+        pthread_getattr_np(pthread_self(), &attributes);
+        std::lock_guard<std::mutex> lock(mutex);
+        pthread_attr_getstacksize(&attributes, &worker_stack);
+        pthread_attr_destroy(&attributes);
+        names.push_back(name);
+        worker_nice = getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)));
+        worker_policy = sched_getscheduler(0);
+    });
+    thread_pool.wait();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(1u, names.size());
+    EXPECT_EQ("attr-test-0", names[0]);
+    pthread_attr_t defaults;
+    size_t default_stack = 0;
+    pthread_attr_init(&defaults);
+    pthread_attr_getstacksize(&defaults, &default_stack);
+    pthread_attr_destroy(&defaults);
+    EXPECT_GE(worker_stack, stack_size);
+    EXPECT_LT(worker_stack, default_stack);
+    EXPECT_EQ(5, worker_nice);
+    EXPECT_EQ(SCHED_BATCH, worker_policy);
+}
+
+TEST(TEST_POOLE_SUITE, WorkerConfig_DefaultNamesWorkers_PASS) {
+    std::string name;
+
+    Poole thread_pool{1};
+    thread_pool.add_function([&name]() {
+        char buffer[16] = {};
+        pthread_getname_np(pthread_self(), buffer, sizeof(buffer));
+        name = buffer;
+    });
+    thread_pool.wait();
+
+    EXPECT_EQ("poole-0", name);
+}
+#endif
+
+TEST(TEST_POOLE_SUITE, LazySpawn_StartsWorkersOnDemand_PASS) {
+    std::atomic<uint32_t> started{0};
+    std::atomic<uint32_t> executed{0};
+
+    WorkerConfig config;
+    config.lazy_spawn = true;
+    config.hooks.on_worker_start = [&started](uint32_t) { started++; };
+    {
+        Poole thread_pool{-1, config};
+        EXPECT_EQ(0u, thread_pool.get_live_threads());
+        EXPECT_EQ(0u, started.load());
+
+        for (int i = 0; i < 100; ++i) {
+            thread_pool.add_function([&executed]() { executed++; });
+        }
+        thread_pool.wait();
+
+        EXPECT_EQ(100u, executed.load());
+        EXPECT_GE(thread_pool.get_live_threads(), 1u);
+        EXPECT_LE(thread_pool.get_live_threads(), thread_pool.get_possible_threads());
+    }
+    EXPECT_GE(started.load(), 1u);
+}
+
+TEST(TEST_POOLE_SUITE, LazySpawn_EagerPoolStartsEveryWorker_PASS) {
+    Poole thread_pool;
+    EXPECT_EQ(thread_pool.get_possible_threads(), thread_pool.get_live_threads());
+}
+
+TEST(TEST_POOLE_SUITE, IdleTimeout_RetiresAndRestartsWorkers_PASS) {
+    std::atomic<uint32_t> started{0};
+    std::atomic<uint32_t> stopped{0};
+    std::atomic<uint32_t> executed{0};
+
+    WorkerConfig config;
+    config.lazy_spawn = true;
+    config.idle_timeout = std::chrono::milliseconds(20);
+    config.hooks.on_worker_start = [&started](uint32_t) { started++; };
+    config.hooks.on_worker_stop = [&stopped](uint32_t) { stopped++; };
+    {
+        Poole thread_pool{-1, config};
+        thread_pool.add_function([&executed]() { executed++; });
+        thread_pool.wait();
+
+        // Every worker gives its thread back once it idled past the timeout
+        for (int i = 0; i < 200 && thread_pool.get_live_threads() > 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        EXPECT_EQ(0u, thread_pool.get_live_threads());
+
+        // Shared and pinned tasks bring them back
+        uint32_t before = started.load();
+        thread_pool.add_function([&executed]() { executed++; });
+        thread_pool.add_function_on(0, [&executed]() { executed++; });
+        thread_pool.wait();
+
+        EXPECT_EQ(3u, executed.load());
+        EXPECT_GT(started.load(), before);
+    }
+    EXPECT_EQ(started.load(), stopped.load());
+}
+
+TEST(TEST_POOLE_SUITE, IdleTimeout_BusyWorkersAreNotRetired_PASS) {
+    std::atomic<uint32_t> stopped{0};
+    std::atomic<uint32_t> executed{0};
+
+    WorkerConfig config;
+    config.idle_timeout = std::chrono::milliseconds(50);
+    config.hooks.on_worker_stop = [&stopped](uint32_t) { stopped++; };
+
+    Poole thread_pool{1, config};
+    for (int i = 0; i < 10; ++i) {
+        thread_pool.add_function([&executed]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            executed++;
+        });
+    }
+    thread_pool.wait();
+
+    EXPECT_EQ(10u, executed.load());
+    EXPECT_EQ(0u, stopped.load());
+}
+
+TEST(TEST_POOLE_SUITE, Global_IsOneSharedPool_PASS) {
+    std::atomic<uint32_t> executed{0};
+
+    EXPECT_EQ(&Poole::global(), &Poole::global());
+    Poole::global().add_function([&executed]() { executed++; });
+    Poole::global().wait();
+
+    EXPECT_EQ(1u, executed.load());
+}
+
+TEST(TEST_POOLE_SUITE, Executor_NamesAreShared_PASS) {
+    std::atomic<uint32_t> executed{0};
+
+    Poole thread_pool;
+    auto first = thread_pool.make_executor("storage", 1);
+    auto second = thread_pool.make_executor("storage", 3);
+    first.add_function([&executed]() { executed++; });
+    second.add_function([&executed]() { executed++; });
+    thread_pool.wait();
+
+    auto stats = thread_pool.get_executor_stats();
+    ASSERT_EQ(1u, stats.size());
+    EXPECT_EQ("storage", stats[0].name);
+    EXPECT_EQ(3u, stats[0].weight);
+    EXPECT_EQ(3u, first.weight());
+    EXPECT_EQ(2u, stats[0].tasks_executed);
+    EXPECT_EQ(0u, stats[0].pending);
+    EXPECT_EQ(2u, executed.load());
+}
+
+TEST(TEST_POOLE_SUITE, Executor_WorkersAreSharedByWeight_PASS) {
+    std::mutex order_mutex;
+    std::vector<char> order;
+
+    // One worker, so the executors compete for it task by task
+    Poole thread_pool{1};
+    auto heavy = thread_pool.make_executor("heavy", 3);
+    auto light = thread_pool.make_executor("light", 1);
+    auto task = [&order_mutex, &order](char executor) {
+        return [&order_mutex, &order, executor]() {
+            auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(50);
+            while (std::chrono::steady_clock::now() < until) {
+            }
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(executor);
+        };
+    };
+
+    thread_pool.pause();
+    for (int i = 0; i < 300; ++i) {
+        heavy.add_function(task('h'));
+        light.add_function(task('l'));
+    }
+    thread_pool.pause(false);
+    thread_pool.wait();
+
+    // While both had work the heavy executor got three quarters of the worker
+    ASSERT_EQ(600u, order.size());
+    auto heavy_first = std::count(order.begin(), order.begin() + 200, 'h');
+    EXPECT_GE(heavy_first, 130);
+    EXPECT_LE(heavy_first, 170);
+}
+
+// Test case: A dispatch may run another executor's task, it is reported under that task's site
+TEST(TEST_POOLE_SUITE, Executor_ReportsTheTaskThatRuns_PASS) {
+    std::atomic<uint32_t> mismatched{0};
+    std::atomic<uint32_t> executed{0};
+    const char* seen = nullptr;
+
+    WorkerConfig config;
+    config.hooks.before_task = [&seen](uint32_t, const TaskSite& site) { seen = site.label; };
+    Poole thread_pool{1, config};
+    auto heavy = thread_pool.make_executor("heavy", 3);
+    auto light = thread_pool.make_executor("light", 1);
+
+    // The light executor's submitters queue first, yet the heavy one runs more
+    thread_pool.pause(true);
+    for (int i = 0; i < 50; ++i) {
+        light.add_function([&]() {
+            mismatched += std::string(seen) != "light";
+            executed++;
+        }, TaskSite::labelled("light"));
+    }
+    for (int i = 0; i < 50; ++i) {
+        heavy.add_function([&]() {
+            mismatched += std::string(seen) != "heavy";
+            executed++;
+        }, TaskSite::labelled("heavy"));
+    }
+    thread_pool.pause(false);
+    thread_pool.wait();
+
+    EXPECT_EQ(100u, executed.load());
+    EXPECT_EQ(0u, mismatched.load());
+}
+
+TEST(TEST_POOLE_SUITE, Executor_AloneGetsEveryWorker_PASS) {
+    std::atomic<uint32_t> executed{0};
+
+    Poole thread_pool;
+    auto background = thread_pool.make_executor("background", 1);
+    thread_pool.make_executor("idle", 100);
+    for (int i = 0; i < 100; ++i) {
+        background.add_function([&executed]() { executed++; });
+    }
+    thread_pool.wait();
+
+    EXPECT_EQ(100u, executed.load());
+}
+
+TEST(TEST_POOLE_SUITE, Oversubscription_ExplicitCountAboveHardware_PASS) {
+    uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    WorkerConfig config;
+    config.allow_oversubscription = true;
+    config.lazy_spawn = true;
+
+    Poole thread_pool{static_cast<int32_t>(hardware * 4), config};
+    EXPECT_EQ(hardware * 4, thread_pool.get_possible_threads());
+
+    // Without it the count stays clamped
+    Poole clamped{static_cast<int32_t>(hardware * 4)};
+    EXPECT_EQ(std::thread::hardware_concurrency(), clamped.get_possible_threads());
+}
+
+// Test case: The only worker blocks on a task queued behind it, a spare runs it
+TEST(TEST_POOLE_SUITE, BlockingRegion_SpareRunsQueuedWork_PASS) {
+    std::atomic<bool> released{false};
+    std::atomic<uint32_t> blocked_seen{0};
+    std::atomic<uint32_t> spare_ran{0};
+
+    WorkerConfig config;
+    config.blocking_spares = WorkerConfig::kSparePerWorker;
+    config.hooks.before_task = [&spare_ran](uint32_t worker_id, const TaskSite&) {
+        if (worker_id == 1) {
+            spare_ran++;
+        }
+    };
+    Poole thread_pool{1, config};
+    EXPECT_EQ(1u, thread_pool.get_spare_threads());
+    EXPECT_EQ(0u, thread_pool.get_blocked_threads());
+
+    // Queued together so that the worker may take both into its batch
+    thread_pool.pause();
+    thread_pool.add_function([&]() {
+        auto blocking = Poole::blocking_region();
+        blocked_seen = thread_pool.get_blocked_threads();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!released.load() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    thread_pool.add_function([&released]() { released = true; });
+    thread_pool.pause(false);
+    thread_pool.wait();
+
+    EXPECT_TRUE(released.load());
+    EXPECT_EQ(1u, blocked_seen.load());
+    EXPECT_EQ(1u, spare_ran.load());
+    EXPECT_EQ(0u, thread_pool.get_blocked_threads());
+}
+
+// Test case: A spare shows in the statistics only once it has stood in
+TEST(TEST_POOLE_SUITE, BlockingRegion_UnstartedSparesAreNotStats_PASS) {
+    WorkerConfig config;
+    config.blocking_spares = 2;
+    Poole thread_pool{1, config};
+    thread_pool.add_function([]() {});
+    thread_pool.wait();
+    EXPECT_EQ(1u, thread_pool.snapshot().threads);
+    EXPECT_EQ(1u, thread_pool.get_thread_total_tasks_executed().size());
+
+    thread_pool.add_function([]() { auto blocking = Poole::blocking_region(); });
+    thread_pool.wait();
+    EXPECT_EQ(2u, thread_pool.snapshot().threads);
+    EXPECT_EQ(2u, thread_pool.get_thread_total_uptime().size());
+    EXPECT_EQ(2u, thread_pool.get_total_tasks_executed());
+}
+
+// Test case: Pools have no spares unless they ask for them
+TEST(TEST_POOLE_SUITE, BlockingRegion_WithoutSparesOnlyCounts_PASS) {
+    std::atomic<uint32_t> blocked{0};
+
+    Poole thread_pool{1};
+    thread_pool.add_function([&]() {
+        auto blocking = Poole::blocking_region();
+        blocked = thread_pool.get_blocked_threads();
+    });
+    thread_pool.wait();
+
+    EXPECT_EQ(1u, blocked.load());
+    EXPECT_EQ(0u, thread_pool.get_spare_threads());
+    EXPECT_EQ(1u, thread_pool.get_live_threads());
+}
+
+TEST(TEST_POOLE_SUITE, BlockingRegion_NestedCountsOnce_PASS) {
+    std::atomic<uint32_t> outer{0};
+    std::atomic<uint32_t> inner{0};
+
+    WorkerConfig config;
+    config.blocking_spares = 2;
+    Poole thread_pool{1, config};
+    thread_pool.add_function([&]() {
+        auto blocking = Poole::blocking_region();
+        {
+            auto nested = Poole::blocking_region();
+            inner = thread_pool.get_blocked_threads();
+        }
+        outer = thread_pool.get_blocked_threads();
+    });
+    thread_pool.wait();
+
+    EXPECT_EQ(1u, inner.load());
+    EXPECT_EQ(1u, outer.load());
+    EXPECT_EQ(0u, thread_pool.get_blocked_threads());
+}
+
+TEST(TEST_POOLE_SUITE, BlockingRegion_OutsideAWorkerDoesNothing_PASS) {
+    WorkerConfig config;
+    config.blocking_spares = 1;
+    config.lazy_spawn = true;
+    Poole thread_pool{1, config};
+    {
+        auto blocking = Poole::blocking_region();
+        EXPECT_TRUE(BlockingRegion::active());
+        EXPECT_EQ(0u, thread_pool.get_blocked_threads());
+    }
+    EXPECT_FALSE(BlockingRegion::active());
+    EXPECT_EQ(0u, thread_pool.get_live_threads());
+}
+
+// Test case: A source is pulled as workers free up, never queued up front
+TEST(TEST_POOLE_SUITE, AddSource_PullsTasksOnDemand_PASS) {
+    std::atomic<uint32_t> executed{0};
+    std::atomic<uint32_t> in_flight{0};
+    std::atomic<uint32_t> peak{0};
+    uint32_t produced = 0;
+
+    Poole thread_pool;
+    thread_pool.add_source([&](Poole::task_type& task) {
+        if (produced == 10000) {
+            return false;
+        }
+        produced++;
+        uint32_t now = ++in_flight;
+        uint32_t seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+        }
+        task = [&executed, &in_flight]() {
+            executed++;
+            in_flight--;
+        };
+        return true;
+    });
+    thread_pool.wait();
+
+    EXPECT_EQ(10000u, executed.load());
+    EXPECT_LE(peak.load(), thread_pool.get_possible_threads());
+    EXPECT_LE(thread_pool.get_peak_pending_tasks(), thread_pool.get_possible_threads());
+}
+
+TEST(TEST_POOLE_SUITE, AddSource_IteratorRange_PASS) {
+    std::vector<uint64_t> input(5000);
+    for (uint64_t i = 0; i < input.size(); ++i) {
+        input[i] = i;
+    }
+    std::atomic<uint64_t> sum{0};
+
+    Poole thread_pool;
+    thread_pool.add_source(input.begin(), input.end(), [&sum](uint64_t value) { sum += value; });
+    thread_pool.add_function([&sum]() { sum += 1; });
+    thread_pool.wait();
+
+    EXPECT_EQ(4999u * 5000u / 2u + 1u, sum.load());
+}
+
+// Test case: Only the tasks a source produced count, not the pulls that found it empty
+TEST(TEST_POOLE_SUITE, AddSource_CountsOnlyProducedTasks_PASS) {
+    std::atomic<uint32_t> executed{0};
+    uint32_t produced = 0;
+
+    Poole thread_pool;
+    thread_pool.add_source([&](Poole::task_type& task) {
+        if (produced == 500) {
+            return false;
+        }
+        produced++;
+        task = [&executed]() { executed++; };
+        return true;
+    });
+    thread_pool.wait();
+
+    EXPECT_EQ(500u, executed.load());
+    EXPECT_EQ(500u, thread_pool.get_total_tasks_executed());
+    EXPECT_EQ(500u, thread_pool.snapshot().tasks_executed);
+}
+
+// Test case: An endless source does not keep a destroyed pool alive
+TEST(TEST_POOLE_SUITE, AddSource_EndlessSourceStopsWithPool_PASS) {
+    std::atomic<uint64_t> executed{0};
+    {
+        Poole thread_pool;
+        thread_pool.add_source([&executed](Poole::task_type& task) {
+            task = [&executed]() { executed++; };
+            return true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_GT(executed.load(), 0u);
+}
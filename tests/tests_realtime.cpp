@@ -0,0 +1,323 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <set>
+#include <string>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "Poole.h"
+
+// NOTE: The global operator new is replaced for the whole test executable. It
+// only counts while g_count_allocations is set, which the real-time tests use
+// to prove that the pool never touches the heap after construction.
+namespace {
+std::atomic<bool> g_count_allocations{false};
+std::atomic<uint64_t> g_allocations{0};
+
+class AllocationGuard {
+ public:
+  AllocationGuard() {
+    g_allocations = 0;
+    g_count_allocations = true;
+  }
+  ~AllocationGuard() {
+    g_count_allocations = false;
+  }
+  uint64_t allocations() const {
+    return g_allocations.load();
+  }
+};
+}  // namespace
+
+void* operator new(std::size_t size) {
+  if (g_count_allocations.load(std::memory_order_relaxed)) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+// INPLACE FUNCTION
+TEST(TEST_REALTIME_SUITE, InplaceFunction_MoveAndCall_PASS) {
+  int calls = 0;
+  InplaceFunction<32> first([&calls]() {
+    calls++;
+  });
+  InplaceFunction<32> second(std::move(first));
+
+  EXPECT_FALSE(static_cast<bool>(first));
+  ASSERT_TRUE(static_cast<bool>(second));
+  second();
+  second();
+  EXPECT_EQ(2, calls);
+}
+
+TEST(TEST_REALTIME_SUITE, InplaceFunction_DestroysCapture_PASS) {
+  auto shared = std::make_shared<int>(5);
+  {
+    InplaceFunction<32> function([shared]() {});
+    EXPECT_EQ(2, shared.use_count());
+  }
+  EXPECT_EQ(1, shared.use_count());
+}
+
+// POOLED FUNCTION
+TEST(TEST_REALTIME_SUITE, PooledFunction_SmallClosureStaysInline_PASS) {
+  int calls = 0;
+  PooledFunction<> function;
+  {
+    AllocationGuard guard;
+    function = PooledFunction<>([&calls]() {
+      calls++;
+    });
+    PooledFunction<> moved(std::move(function));
+    moved();
+    EXPECT_EQ(0u, moved.heap_bytes());
+    EXPECT_EQ(0u, guard.allocations());
+  }
+  EXPECT_EQ(1, calls);
+}
+
+TEST(TEST_REALTIME_SUITE, PooledFunction_NodesReturnAcrossThreads_PASS) {
+  const int num_functions = 1000;
+  std::array<uint64_t, 32> payload{};
+  auto large_task = [payload]() {};
+  static_assert(sizeof(large_task) > 48, "The closure must not fit inline");
+
+  // Created here and destroyed on another thread, like a submitted task
+  std::vector<PooledFunction<>> functions;
+  functions.reserve(num_functions);
+  auto round = [&functions, &large_task, num_functions]() {
+    for (int i = 0; i < num_functions; ++i) {
+      functions.emplace_back(large_task);
+    }
+    std::thread([&functions]() {
+      functions.clear();
+    }).join();
+  };
+
+  // Fill the node caches, after which freed nodes come back in batches
+  round();
+  round();
+  AllocationGuard guard;
+  round();
+  // The thread itself allocates, but a std::function would allocate per closure
+  EXPECT_LT(guard.allocations(), static_cast<uint64_t>(num_functions / 10));
+}
+
+// Test case: A burst bigger than the shared lists hold returns its memory
+TEST(TEST_REALTIME_SUITE, PooledFunction_BurstBeyondSharedListsIsFreed_PASS) {
+  const int num_functions = 5000;
+  std::array<uint64_t, 32> payload{};
+  auto large_task = [payload]() {};
+
+  std::vector<PooledFunction<>> functions;
+  functions.reserve(num_functions);
+  for (int i = 0; i < num_functions; ++i) {
+    functions.emplace_back(large_task);
+  }
+  uint64_t released = TaskNodePool::released_nodes();
+  std::thread([&functions]() {
+    functions.clear();
+  }).join();
+
+  // At most the shared lists and the exiting thread's cache hold on to nodes
+  uint64_t kept = (TaskNodePool::kMaxSharedBatches + 2) * TaskNodePool::kBatch;
+  EXPECT_GE(TaskNodePool::released_nodes() - released, num_functions - kept);
+}
+
+TEST(TEST_REALTIME_SUITE, PooledFunction_LargeClosuresAreCounted_PASS) {
+  const int num_tasks = 500;
+  std::array<uint64_t, 32> payload{};
+  payload.fill(1);
+  std::atomic<uint64_t> sum{0};
+  auto large_task = [payload, &sum]() {
+    uint64_t total = 0;
+    for (auto value : payload) {
+      total += value;
+    }
+    sum += total;
+  };
+
+  Poole thread_pool{2};
+  for (int i = 0; i < num_tasks; ++i) {
+    thread_pool.add_function(large_task);
+  }
+  thread_pool.wait();
+
+  EXPECT_EQ(32u * num_tasks, sum.load());
+  EXPECT_EQ(static_cast<uint64_t>(num_tasks), thread_pool.get_total_task_allocations());
+  EXPECT_EQ(num_tasks * sizeof(large_task), thread_pool.get_total_task_allocated_bytes());
+  EXPECT_NE(std::string::npos, thread_pool.statistics().find("Task Storage: 1.00 allocations"));
+}
+
+TEST(TEST_REALTIME_SUITE, PooledFunction_SmallTasksAreNotCounted_FAIL) {
+  Poole thread_pool{1};
+  for (int i = 0; i < 100; ++i) {
+    thread_pool.add_function([]() {});
+  }
+  thread_pool.wait();
+
+  EXPECT_EQ(0u, thread_pool.get_total_task_allocations());
+  EXPECT_EQ(0u, thread_pool.snapshot().task_allocated_bytes);
+}
+
+// REALTIME POOLE
+TEST(TEST_REALTIME_SUITE, RealtimePoole_NoAllocationAfterConstruction_PASS) {
+  const int num_tasks = 5000;
+  std::atomic<int> counter{0};
+
+  // Fewer slots than tasks, so submitters also block on a full queue
+  RealtimePoole<64, 32> thread_pool{2};
+  {
+    AllocationGuard guard;
+    for (int i = 0; i < num_tasks; ++i) {
+      thread_pool.add_function([&counter]() {
+        counter++;
+      });
+    }
+    thread_pool.wait();
+    EXPECT_EQ(0u, guard.allocations());
+  }
+
+  EXPECT_EQ(num_tasks, counter.load());
+  EXPECT_EQ(static_cast<uint64_t>(num_tasks), thread_pool.get_total_tasks_executed());
+}
+
+TEST(TEST_REALTIME_SUITE, RealtimePoole_TryAddFunctionWhenFull_FAIL) {
+  const int capacity = 4;
+  std::atomic<int> counter{0};
+
+  RealtimePoole<capacity, 32> thread_pool{1};
+  thread_pool.pause(true);
+  for (int i = 0; i < capacity; ++i) {
+    EXPECT_TRUE(thread_pool.try_add_function([&counter]() {
+      counter++;
+    }));
+  }
+  EXPECT_FALSE(thread_pool.try_add_function([&counter]() {
+    counter++;
+  }));
+
+  thread_pool.pause(false);
+  thread_pool.wait();
+  EXPECT_EQ(capacity, counter.load());
+}
+
+TEST(TEST_REALTIME_SUITE, RealtimePoole_ProducersBlockUntilSpace_PASS) {
+  const int num_producers = 3;
+  const int tasks_per_producer = 300;
+  std::atomic<int> counter{0};
+
+  RealtimePoole<8, 32> thread_pool{2};
+  std::vector<std::thread> producers;
+  for (int p = 0; p < num_producers; ++p) {
+    producers.emplace_back([&thread_pool, &counter, tasks_per_producer]() {
+      for (int i = 0; i < tasks_per_producer; ++i) {
+        thread_pool.add_function([&counter]() {
+          counter++;
+        });
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  thread_pool.wait();
+
+  EXPECT_EQ(num_producers * tasks_per_producer, counter.load());
+}
+
+TEST(TEST_REALTIME_SUITE, RealtimePoole_StrandTasksAvoidTheHeap_PASS) {
+  const int num_tasks = 500;
+  std::atomic<int> counter{0};
+
+  RealtimePoole<1024, 64> thread_pool{1};
+  auto strand = thread_pool.make_strand();
+  // The first round takes fresh nodes, the worker passes them back in batches
+  for (int i = 0; i < 2 * num_tasks; ++i) {
+    strand.add_function([&counter]() { counter++; });
+  }
+  thread_pool.wait();
+  {
+    AllocationGuard guard;
+    for (int i = 0; i < num_tasks; ++i) {
+      strand.add_function([&counter]() { counter++; });
+    }
+    thread_pool.wait();
+    EXPECT_EQ(0u, guard.allocations());
+  }
+
+  EXPECT_EQ(3 * num_tasks, counter.load());
+}
+
+// Test case: The only worker adds a source while the queue is full
+TEST(TEST_REALTIME_SUITE, RealtimePoole_SourceFromAFullQueue_PASS) {
+  WorkerConfig config;
+  config.blocking_spares = 0;
+  RealtimePoole<4, 32> thread_pool{1, config};
+  std::atomic<uint32_t> counter{0};
+  uint32_t queued = 0;
+  uint32_t produced = 0;
+
+  thread_pool.add_function([&]() {
+    while (thread_pool.try_add_function([&counter]() { counter++; })) {
+      queued++;
+    }
+    thread_pool.add_source([&](RealtimePoole<4, 32>::task_type& task) {
+      if (produced == 100) {
+        return false;
+      }
+      produced++;
+      task = [&counter]() { counter++; };
+      return true;
+    });
+  });
+  thread_pool.wait();
+
+  EXPECT_EQ(queued + 100u, counter.load());
+  EXPECT_EQ(queued + 101u, thread_pool.get_total_tasks_executed());
+}
+
+TEST(TEST_REALTIME_SUITE, RealtimePoole_WorkerArenaAvoidsTheHeap_PASS) {
+  const int num_tasks = 1000;
+  std::atomic<uint64_t> counter{0};
+  auto task = [&counter]() {
+    std::pmr::set<uint64_t> seen(RealtimePoole<64, 32>::this_worker_arena());
+    for (uint64_t i = 0; i < 50; ++i) {
+      seen.insert(i * 7);
+    }
+    counter += seen.size();
+  };
+
+  RealtimePoole<64, 32> thread_pool{1};
+  // The arena takes its first chunk on first use
+  thread_pool.add_function(task);
+  thread_pool.wait();
+  {
+    AllocationGuard guard;
+    for (int i = 0; i < num_tasks; ++i) {
+      thread_pool.add_function(task);
+    }
+    thread_pool.wait();
+    EXPECT_EQ(0u, guard.allocations());
+  }
+
+  EXPECT_EQ(50u * (num_tasks + 1), counter.load());
+}
@@ -0,0 +1,223 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "Poole.h"
+
+namespace {
+PooleStats make_stats() {
+  PooleStats stats;
+  stats.threads = 1;
+  stats.tasks_executed = 42;
+  stats.pending = 3;
+  stats.outstanding = 5;
+  stats.utilization = 0.5;
+
+  ThreadSnapshot worker;
+  worker.id = 0;
+  worker.state = static_cast<uint8_t>(ThreadInfo::State::Busy);
+  worker.tasks = 42;
+  worker.busy_ns = 1500000000;
+  worker.idle_ns = 1500000000;
+  worker.utilization = 0.5;
+  stats.workers.push_back(worker);
+  return stats;
+}
+}  // namespace
+
+TEST(TEST_STATS_SUITE, Snapshot_MatchesTotals_PASS) {
+  const int num_tasks = 500;
+  std::atomic<int> counter{0};
+
+  Poole thread_pool{2};
+  for (int i = 0; i < num_tasks; ++i) {
+    thread_pool.add_function([&counter]() {
+      counter++;
+    });
+  }
+  thread_pool.wait();
+
+  PooleStats stats = thread_pool.snapshot();
+  EXPECT_EQ(thread_pool.get_possible_threads(), stats.threads);
+  EXPECT_EQ(static_cast<size_t>(stats.threads), stats.workers.size());
+  EXPECT_EQ(static_cast<uint64_t>(num_tasks), stats.tasks_executed);
+  EXPECT_EQ(0u, stats.outstanding);
+
+  uint64_t per_worker = 0;
+  for (const auto& worker : stats.workers) {
+    per_worker += worker.tasks;
+  }
+  EXPECT_EQ(stats.tasks_executed, per_worker);
+}
+
+TEST(TEST_STATS_SUITE, FormatJson_WritesSnapshot_PASS) {
+  char buffer[1024];
+  std::size_t length = format_json(make_stats(), buffer, sizeof(buffer));
+
+  EXPECT_EQ(std::strlen(buffer), length);
+  EXPECT_EQ(std::string("{\"threads\":1,\"tasks_executed\":42,\"tasks_stolen\":0,\"spurious_wakeups\":0,"
+                        "\"pending\":3,\"running\":0,\"outstanding\":5,\"peak_pending\":0,\"task_allocations\":0,"
+                        "\"task_allocated_bytes\":0,\"uptime_ms\":0,\"utilization\":0.500000,"
+                        "\"workers\":[{\"id\":0,\"state\":\"busy\",\"tasks\":42,\"uptime_ms\":0,"
+                        "\"busy_ns\":1500000000,\"idle_ns\":1500000000,\"parked_ns\":0,\"cpu_ns\":0,"
+                        "\"utilization\":0.500000}]}"),
+      std::string(buffer));
+}
+
+TEST(TEST_STATS_SUITE, FormatJson_SmallBufferIsTerminated_FAIL) {
+  char buffer[16];
+  std::memset(buffer, 'x', sizeof(buffer));
+  std::size_t length = format_json(make_stats(), buffer, sizeof(buffer));
+
+  EXPECT_GT(length, sizeof(buffer));
+  EXPECT_EQ(sizeof(buffer) - 1, std::strlen(buffer));
+  EXPECT_EQ(std::string("{\"threads\":1,\"t"), std::string(buffer));
+
+  // Asking with no buffer at all only measures
+  EXPECT_EQ(length, format_json(make_stats(), nullptr, 0));
+}
+
+TEST(TEST_STATS_SUITE, FormatOpenMetrics_WritesSnapshot_PASS) {
+  char buffer[4096];
+  std::size_t length = format_openmetrics(make_stats(), buffer, sizeof(buffer));
+  ASSERT_LT(length, sizeof(buffer));
+  std::string text(buffer);
+
+  EXPECT_NE(std::string::npos, text.find("# TYPE poole_tasks_executed counter\n"));
+  EXPECT_NE(std::string::npos, text.find("\npoole_tasks_executed_total 42\n"));
+  EXPECT_NE(std::string::npos, text.find("\npoole_pending_tasks 3\n"));
+  EXPECT_NE(std::string::npos, text.find("# UNIT poole_worker_busy_seconds seconds\n"));
+  EXPECT_NE(std::string::npos, text.find("\npoole_worker_busy_seconds_total{worker=\"0\"} 1.500000\n"));
+  EXPECT_NE(std::string::npos, text.find("\npoole_worker_utilization{worker=\"0\"} 0.500000\n"));
+  EXPECT_EQ(text.size() - 6, text.rfind("# EOF\n"));
+}
+
+TEST(TEST_STATS_SUITE, Snapshot_WhileWorkersRun_PASS) {
+  const int num_tasks = 20000;
+  std::atomic<int> counter{0};
+
+  Poole thread_pool{2};
+  for (int i = 0; i < num_tasks; ++i) {
+    thread_pool.add_function([&counter]() {
+      counter++;
+    });
+  }
+
+  // Counts only ever grow between snapshots taken during the run
+  PooleStats stats;
+  uint64_t last = 0;
+  char buffer[4096];
+  while (counter.load() < num_tasks) {
+    thread_pool.snapshot(stats);
+    EXPECT_GE(stats.tasks_executed, last);
+    last = stats.tasks_executed;
+    format_openmetrics(stats, buffer, sizeof(buffer));
+  }
+  thread_pool.wait();
+
+  thread_pool.snapshot(stats);
+  EXPECT_EQ(static_cast<uint64_t>(num_tasks), stats.tasks_executed);
+}
+
+TEST(TEST_STATS_SUITE, TaskTimePercentile_FromBuckets_PASS) {
+  uint64_t buckets[ThreadInfo::kTaskTimeBuckets] = {};
+  EXPECT_EQ(0u, poole_task_time_percentile(buckets, 0.5));
+
+  // 90 tasks under 1 us (bucket 9) and 10 tasks under 1 ms (bucket 19)
+  buckets[9] = 90;
+  buckets[19] = 10;
+  EXPECT_EQ(1024u, poole_task_time_percentile(buckets, 0.5));
+  EXPECT_EQ(1024u, poole_task_time_percentile(buckets, 0.9));
+  EXPECT_EQ(1048576u, poole_task_time_percentile(buckets, 0.99));
+}
+
+TEST(TEST_STATS_SUITE, StatsSegment_PublishAndRead_PASS) {
+  const int num_tasks = 300;
+  const std::string path = "/tmp/poole_tests_segment_" + std::to_string(::getpid());
+  std::atomic<int> counter{0};
+
+  Poole thread_pool{2};
+  ASSERT_TRUE(thread_pool.publish_stats(path, std::chrono::milliseconds(5)));
+  for (int i = 0; i < num_tasks; ++i) {
+    thread_pool.add_function([&counter]() {
+      counter++;
+    });
+  }
+  thread_pool.wait();
+
+  StatsSegment::Reader reader;
+  ASSERT_TRUE(reader.open(path));
+  EXPECT_EQ(static_cast<uint32_t>(::getpid()), reader.pid());
+
+  // Wait for a publication that includes every task
+  StatsSegment::Data data{};
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (std::chrono::steady_clock::now() < deadline
+      && !(reader.read(data) && data.tasks_executed == static_cast<uint64_t>(num_tasks))) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(static_cast<uint64_t>(num_tasks), data.tasks_executed);
+  EXPECT_EQ(thread_pool.get_possible_threads(), data.worker_count);
+  uint64_t timed = 0;
+  for (uint64_t bucket : data.task_time_buckets) {
+    timed += bucket;
+  }
+  EXPECT_EQ(static_cast<uint64_t>(num_tasks), timed);
+
+  // The segment disappears with the publisher
+  thread_pool.stop_publishing_stats();
+  StatsSegment::Reader late_reader;
+  EXPECT_FALSE(late_reader.open(path));
+}
+
+TEST(TEST_STATS_SUITE, StatsSegment_RejectsOtherFiles_FAIL) {
+  const std::string path = "/tmp/poole_tests_not_a_segment_" + std::to_string(::getpid());
+  std::FILE* file = std::fopen(path.c_str(), "w");
+  ASSERT_NE(nullptr, file);
+  std::string junk(sizeof(StatsSegment::Layout), 'x');
+  std::fwrite(junk.data(), 1, junk.size(), file);
+  std::fclose(file);
+
+  StatsSegment::Reader reader;
+  EXPECT_FALSE(reader.open(path));
+  std::remove(path.c_str());
+}
+
+TEST(TEST_STATS_SUITE, Sampler_KeepsTheLastWindow_PASS) {
+  const std::size_t window = 4;
+
+  Poole thread_pool{1};
+  EXPECT_TRUE(thread_pool.get_samples().empty());
+  thread_pool.start_sampling(std::chrono::milliseconds(10), window);
+
+  // Keep the pool working for a few more periods than the window holds
+  auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(150);
+  while (std::chrono::steady_clock::now() < end) {
+    for (int i = 0; i < 50; ++i) {
+      thread_pool.add_function([]() {});
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  thread_pool.wait();
+
+  std::vector<PooleSample> samples = thread_pool.get_samples();
+  ASSERT_EQ(window, samples.size());
+  double total_rate = 0.0;
+  for (std::size_t i = 1; i < samples.size(); ++i) {
+    EXPECT_GT(samples[i].time_ms, samples[i - 1].time_ms);
+  }
+  for (const auto& sample : samples) {
+    total_rate += sample.tasks_per_second;
+    EXPECT_GE(sample.wait_ms, 0.0);
+  }
+  EXPECT_GT(total_rate, 0.0);
+
+  thread_pool.stop_sampling();
+  EXPECT_TRUE(thread_pool.get_samples().empty());
+}
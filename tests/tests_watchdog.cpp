@@ -0,0 +1,151 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "Poole.h"
+
+namespace {
+const CallsiteReport* find_label(const std::vector<CallsiteReport>& report, const char* label) {
+  for (const auto& callsite : report) {
+    if (callsite.site.label != nullptr && std::strcmp(callsite.site.label, label) == 0) {
+      return &callsite;
+    }
+  }
+  return nullptr;
+}
+
+WatchdogConfig short_thresholds() {
+  WatchdogConfig config;
+  config.run_threshold = std::chrono::milliseconds(10);
+  config.wait_threshold = std::chrono::milliseconds(10);
+  config.scan_interval = std::chrono::milliseconds(2);
+  return config;
+}
+}  // namespace
+
+// TASK SITE
+TEST(TEST_WATCHDOG_SUITE, TaskSite_CapturesCaller_PASS) {
+  const uint32_t line = __LINE__ + 1;
+  TaskSite site = TaskSite::current();
+  TaskSite labelled = TaskSite::labelled("ingest");
+
+  EXPECT_NE(nullptr, std::strstr(site.file, "tests_watchdog.cpp"));
+  EXPECT_EQ(line, site.line);
+  EXPECT_EQ(nullptr, site.label);
+  EXPECT_STREQ("ingest", labelled.label);
+  EXPECT_EQ(line + 1, labelled.line);
+}
+
+// WATCHDOG
+TEST(TEST_WATCHDOG_SUITE, Watchdog_FlagsSlowRunAtCallsite_PASS) {
+  std::mutex mutex;
+  std::vector<SlowTask> flagged;
+  WatchdogConfig config = short_thresholds();
+  config.wait_threshold = std::chrono::nanoseconds(0);
+  config.on_slow_task = [&mutex, &flagged](const SlowTask& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    flagged.push_back(task);
+  };
+
+  Poole thread_pool{2};
+  thread_pool.enable_watchdog(config);
+  for (int i = 0; i < 20; ++i) {
+    thread_pool.add_function([]() {});
+  }
+  const uint32_t line = __LINE__ + 1;
+  thread_pool.add_function([]() { std::this_thread::sleep_for(std::chrono::milliseconds(40)); });
+  thread_pool.add_function([]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }, TaskSite::labelled("slow-ingest"));
+  thread_pool.wait();
+
+  std::vector<CallsiteReport> report = thread_pool.get_watchdog_report();
+  ASSERT_EQ(2u, report.size());
+
+  const CallsiteReport* labelled = find_label(report, "slow-ingest");
+  ASSERT_NE(nullptr, labelled);
+  EXPECT_EQ(1u, labelled->slow_runs);
+  EXPECT_GE(labelled->max_run_ns, 20000000u);
+
+  const CallsiteReport& unlabelled = &report[0] == labelled ? report[1] : report[0];
+  EXPECT_NE(nullptr, std::strstr(unlabelled.site.file, "tests_watchdog.cpp"));
+  EXPECT_EQ(line, unlabelled.site.line);
+  EXPECT_EQ(1u, unlabelled.slow_runs);
+  // The 40ms task was caught by the scan while it was still running
+  EXPECT_EQ(1u, unlabelled.still_running);
+  EXPECT_EQ(0u, unlabelled.slow_waits);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_GE(flagged.size(), 3u);
+}
+
+TEST(TEST_WATCHDOG_SUITE, Watchdog_FlagsQueueWait_PASS) {
+  Poole thread_pool{1};
+  thread_pool.enable_watchdog(short_thresholds());
+
+  thread_pool.add_function([]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  }, TaskSite::labelled("blocker"));
+  thread_pool.add_function([]() {}, TaskSite::labelled("starved"));
+  thread_pool.wait();
+
+  std::vector<CallsiteReport> report = thread_pool.get_watchdog_report();
+  const CallsiteReport* starved = find_label(report, "starved");
+  ASSERT_NE(nullptr, starved);
+  EXPECT_EQ(1u, starved->slow_waits);
+  EXPECT_EQ(0u, starved->slow_runs);
+  EXPECT_GE(starved->max_wait_ns, 10000000u);
+}
+
+TEST(TEST_WATCHDOG_SUITE, Watchdog_DisabledRecordsNothing_FAIL) {
+  Poole thread_pool{1};
+  thread_pool.enable_watchdog(short_thresholds());
+  thread_pool.disable_watchdog();
+
+  thread_pool.add_function([]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  });
+  thread_pool.wait();
+
+  EXPECT_TRUE(thread_pool.get_watchdog_report().empty());
+}
+
+// Test case: A pipeline run on the only worker runs its stages nested in the
+// caller, which is still the task flagged
+TEST(TEST_WATCHDOG_SUITE, Watchdog_FlagsTaskRunningNestedTasks_PASS) {
+  WatchdogConfig config = short_thresholds();
+  config.wait_threshold = std::chrono::nanoseconds(0);
+  WorkerConfig worker_config;
+  worker_config.blocking_spares = 0;
+  Poole thread_pool{1, worker_config};
+  thread_pool.enable_watchdog(config);
+
+  std::atomic<uint64_t> produced{0};
+  thread_pool.add_function([&]() {
+    uint64_t next = 0;
+    BasicPipeline<Poole, uint64_t> pipeline(thread_pool, 2);
+    pipeline
+        .source([&next](uint64_t& item) {
+          if (next == 30) {
+            return false;
+          }
+          item = next++;
+          return true;
+        })
+        .stage(StageMode::parallel, [](uint64_t&) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+    produced = pipeline.run();
+  }, TaskSite::labelled("pipeline-caller"));
+  thread_pool.wait();
+
+  EXPECT_EQ(30u, produced.load());
+  std::vector<CallsiteReport> report = thread_pool.get_watchdog_report();
+  const CallsiteReport* caller = find_label(report, "pipeline-caller");
+  ASSERT_NE(nullptr, caller);
+  EXPECT_EQ(1u, caller->slow_runs);
+  EXPECT_GE(caller->max_run_ns, 30000000u);
+}
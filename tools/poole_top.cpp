@@ -0,0 +1,187 @@
+/**   Copyright 2020 Benrick Smit
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @author: Benrick Smit
+ * @date: 19 October 2026
+ * @modified: 19 October 2026
+ *
+ * @brief: poole-top attaches to the statistics segment of a running pool (see
+ *          BasicPoole::publish_stats) and shows a live per-worker view of it.
+ *          Rates and percentages are taken over the last refresh interval.
+ *
+ *          Usage: poole-top SEGMENT [--interval MS] [--count N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "StatsSegment.h"
+
+namespace {
+
+struct TopOptions {
+    std::string segment;
+    int interval_ms = 1000;
+    // The number of refreshes before exiting, 0 keeps going
+    int count = 0;
+};
+
+bool parse_options(int argc, char** argv, TopOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        bool has_value = (i + 1 < argc);
+
+        if (argument == "--interval" && has_value) {
+            options.interval_ms = std::max(10, std::atoi(argv[++i]));
+        } else if (argument == "--count" && has_value) {
+            options.count = std::max(0, std::atoi(argv[++i]));
+        } else if (options.segment.empty() && argument[0] != '-') {
+            options.segment = argument;
+        } else {
+            options.segment.clear();
+            break;
+        }
+    }
+    if (options.segment.empty()) {
+        std::cerr << "Usage: " << argv[0] << " SEGMENT [--interval MS] [--count N]" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Prints a duration in the most readable unit
+std::string format_time(uint64_t nanoseconds) {
+    char text[32];
+    if (nanoseconds < 1000) {
+        std::snprintf(text, sizeof(text), "%llu ns", static_cast<unsigned long long>(nanoseconds));
+    } else if (nanoseconds < 1000000) {
+        std::snprintf(text, sizeof(text), "%.1f us", nanoseconds / 1e3);
+    } else if (nanoseconds < 1000000000) {
+        std::snprintf(text, sizeof(text), "%.1f ms", nanoseconds / 1e6);
+    } else {
+        std::snprintf(text, sizeof(text), "%.1f s", nanoseconds / 1e9);
+    }
+    return text;
+}
+
+double percent(uint64_t part, uint64_t whole) {
+    return whole == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(whole);
+}
+
+// Shows the current data, using the previous data for the rates. Without a
+// previous publication the rates cover the whole lifetime of the pool.
+void render(const StatsSegment::Data& now, const StatsSegment::Data& before, bool has_before,
+        uint32_t pid, bool clear_screen) {
+    static const char* kStateNames[] = {"busy", "idle", "parked", "stopped"};
+
+    double seconds = has_before ? (now.published_ns - before.published_ns) / 1e9 : now.uptime_ms / 1e3;
+    seconds = std::max(seconds, 1e-9);
+
+    // The task times of the interval only, when there is a previous publication
+    uint64_t buckets[ThreadInfo::kTaskTimeBuckets];
+    for (int i = 0; i < ThreadInfo::kTaskTimeBuckets; ++i) {
+        buckets[i] = now.task_time_buckets[i] - (has_before ? before.task_time_buckets[i] : 0);
+    }
+
+    if (clear_screen) {
+        std::printf("\033[H\033[2J");
+    }
+    uint64_t tasks = now.tasks_executed - (has_before ? before.tasks_executed : 0);
+    std::printf("poole-top  pid %u  threads %u  uptime %.1f s\n", pid, now.threads, now.uptime_ms / 1e3);
+    std::printf("tasks %llu (%.1f/s)  pending %llu (peak %llu)  running %llu  stolen %llu  spurious wake-ups %llu\n",
+            static_cast<unsigned long long>(now.tasks_executed), tasks / seconds,
+            static_cast<unsigned long long>(now.pending), static_cast<unsigned long long>(now.peak_pending),
+            static_cast<unsigned long long>(now.running),
+            static_cast<unsigned long long>(now.tasks_stolen),
+            static_cast<unsigned long long>(now.spurious_wakeups));
+    uint64_t allocations = now.task_allocations - (has_before ? before.task_allocations : 0);
+    uint64_t allocated_bytes = now.task_allocated_bytes - (has_before ? before.task_allocated_bytes : 0);
+    double per_task = 1.0 / static_cast<double>(std::max<uint64_t>(tasks, 1));
+    std::printf("task time  p50 %s  p90 %s  p99 %s  storage %.2f allocs/task %.1f B/task\n\n",
+            format_time(poole_task_time_percentile(buckets, 0.50)).c_str(),
+            format_time(poole_task_time_percentile(buckets, 0.90)).c_str(),
+            format_time(poole_task_time_percentile(buckets, 0.99)).c_str(),
+            allocations * per_task, allocated_bytes * per_task);
+
+    std::printf("%6s %-8s %12s %10s %7s %7s %7s %7s\n",
+            "WORKER", "STATE", "TASKS", "TASKS/S", "BUSY%", "IDLE%", "PARKED%", "CPU%");
+    for (uint32_t i = 0; i < now.worker_count; ++i) {
+        const StatsSegment::Worker& worker = now.workers[i];
+        StatsSegment::Worker previous{};
+        if (has_before && i < before.worker_count) {
+            previous = before.workers[i];
+        }
+        uint64_t busy = worker.busy_ns - previous.busy_ns;
+        uint64_t idle = worker.idle_ns - previous.idle_ns;
+        uint64_t parked = worker.parked_ns - previous.parked_ns;
+        uint64_t total = busy + idle + parked;
+        uint64_t cpu = worker.cpu_ns - previous.cpu_ns;
+
+        std::printf("%6u %-8s %12llu %10.1f %7.1f %7.1f %7.1f %7.1f\n",
+                worker.id, worker.state < 4 ? kStateNames[worker.state] : "unknown",
+                static_cast<unsigned long long>(worker.tasks), (worker.tasks - previous.tasks) / seconds,
+                percent(busy, total), percent(idle, total), percent(parked, total),
+                percent(cpu, static_cast<uint64_t>(seconds * 1e9)));
+    }
+    if (now.worker_count < now.threads) {
+        std::printf("(%u more workers not published)\n", now.threads - now.worker_count);
+    }
+    std::fflush(stdout);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    TopOptions options;
+    if (!parse_options(argc, argv, options)) {
+        return 1;
+    }
+
+    StatsSegment::Reader reader;
+    if (!reader.open(options.segment)) {
+        std::cerr << "ERROR: poole-top - " << options.segment << " is not a Poole statistics segment" << std::endl;
+        return 1;
+    }
+
+    bool clear_screen = ::isatty(STDOUT_FILENO) && options.count != 1;
+    StatsSegment::Data before{};
+    StatsSegment::Data now{};
+    bool has_before = false;
+    for (int refresh = 0; options.count == 0 || refresh < options.count; ++refresh) {
+        if (refresh > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.interval_ms));
+        }
+        if (!reader.read(now)) {
+            std::cerr << "ERROR: poole-top - nothing has been published to " << options.segment << std::endl;
+            return 1;
+        }
+        // Only compare with the previous publication if a new one arrived
+        bool compare = has_before && now.publish_count != before.publish_count;
+        render(now, before, compare, reader.pid(), clear_screen);
+        if (!has_before || compare) {
+            before = now;
+            has_before = true;
+        }
+    }
+
+    return 0;
+}